@@ -38,12 +38,25 @@ int main(int argc, char* argv[])
                           ? expand_path("${__PLOTTING_OUTPUT_DIR}/")
                           : "plotting_output/";
 
+  // data cache is only used if explicitly requested
+  string cacheFolder = (gSystem->Getenv("__PLOTTING_CACHE_DIR"))
+                         ? expand_path("${__PLOTTING_CACHE_DIR}/")
+                         : "";
+  uint64_t cacheSize = 2048;
+  bool useDataCatalog = false;
+  bool useLazyLoading = false;
+  uint64_t memoryBudget = 0;
+  bool watchFiles = false;
+  uint32_t prefetchDepth = 0;
+  bool forceRebuild = false;
+
   string inputFilesConfig = configFolder + "inputFiles.XML";
   string plotDefConfig = configFolder + "plotDefinitions.XML";
 
   string mode;
   string figureGroups;
   string plotNames;
+  uint32_t nJobs = 1;
 
   // handle user inputs
   try {
@@ -53,7 +66,17 @@ int main(int argc, char* argv[])
       "Location of config file containing the input file paths.")(
       "plotDefConfig", po::value<string>(),
       "Location of config file containing the plot definitions.")(
-      "outputFolder", po::value<string>(), "Folder where output files should be saved.");
+      "outputFolder", po::value<string>(), "Folder where output files should be saved.")(
+      "jobs,j", po::value<uint32_t>(), "Number of threads used to read the input files and of processes that create the plots in parallel.")(
+      "cacheFolder", po::value<string>(), "Folder where data extracted from the input files should be cached.")(
+      "cacheSize", po::value<uint64_t>(), "Maximum size of the data cache in MB.")(
+      "no-cache", "Do not use the data cache.")(
+      "catalog", "Use a catalog of the input file contents (stored next to the input files config) to directly access the data.")(
+      "lazy", "Load the input data only when the plot needing them is generated.")(
+      "memoryBudget", po::value<uint64_t>(), "Maximum memory in MB occupied by input data. Data are then released once they are no longer needed.")(
+      "prefetch", po::value<uint32_t>(), "Number of upcoming plots whose input data are read in the background while a plot is generated.")(
+      "watch", "Keep running and re-create the plots affected by changes of the input files or plot definitions.")(
+      "force", "Re-create all plots even if their definitions and input files did not change since they were last created.");
 
     po::options_description arguments("Positional arguments");
     arguments.add_options()("mode", po::value<string>(), "mode")(
@@ -98,6 +121,7 @@ int main(int argc, char* argv[])
         "directory");
       PRINT(
         "can be steered via the env variables __PLOTTING_CONFIG_DIR and __PLOTTING_OUTPUT_DIR.");
+      PRINT("A persistent cache for the input data can be enabled via __PLOTTING_CACHE_DIR.");
       PRINT("Alternatively the following command line options can be used:");
       PRINT("");
       cout << options << endl;
@@ -112,6 +136,36 @@ int main(int argc, char* argv[])
     if (vm.count("outputFolder")) {
       outputFolder = vm["outputFolder"].as<string>();
     }
+    if (vm.count("cacheFolder")) {
+      cacheFolder = vm["cacheFolder"].as<string>();
+    }
+    if (vm.count("cacheSize")) {
+      cacheSize = vm["cacheSize"].as<uint64_t>();
+    }
+    if (vm.count("no-cache")) {
+      cacheFolder.clear();
+    }
+    if (vm.count("catalog")) {
+      useDataCatalog = true;
+    }
+    if (vm.count("lazy")) {
+      useLazyLoading = true;
+    }
+    if (vm.count("memoryBudget")) {
+      memoryBudget = vm["memoryBudget"].as<uint64_t>();
+    }
+    if (vm.count("prefetch")) {
+      prefetchDepth = vm["prefetch"].as<uint32_t>();
+    }
+    if (vm.count("watch")) {
+      watchFiles = true;
+    }
+    if (vm.count("force")) {
+      forceRebuild = true;
+    }
+    if (vm.count("jobs")) {
+      nJobs = vm["jobs"].as<uint32_t>();
+    }
     if (vm.count("mode")) {
       mode = vm["mode"].as<string>();
     }
@@ -155,6 +209,16 @@ int main(int argc, char* argv[])
   // create plotting environment
   PlotManager plotManager;
   plotManager.SetOutputDirectory(outputFolder);
+  plotManager.SetNumLoaderThreads(nJobs);
+  plotManager.SetNumRenderProcesses(nJobs);
+  plotManager.SetCacheDirectory(cacheFolder);
+  plotManager.SetCacheSizeLimit(cacheSize);
+  plotManager.SetUseDataCatalog(useDataCatalog);
+  plotManager.SetUseLazyLoading(useLazyLoading);
+  plotManager.SetMemoryBudget(memoryBudget);
+  plotManager.SetPrefetchDepth(prefetchDepth);
+  plotManager.SetUseBuildManifest();
+  plotManager.SetForceRebuild(forceRebuild);
   INFO(R"(Reading plot definitions from "{}".)", plotDefConfig);
 
   vector<string> figureGroupsVector = split_string(figureGroups, ' ');
@@ -179,6 +243,10 @@ int main(int argc, char* argv[])
   } else {
     INFO(R"(Reading input files from "{}".)", inputFilesConfig);
     plotManager.LoadInputDataFiles(inputFilesConfig);
+    if (watchFiles) {
+      plotManager.WatchPlots(plotDefConfig, figureGroupsVector, plotNamesVector, mode);
+      return 0;
+    }
     plotManager.ExtractPlotsFromFile(plotDefConfig, figureGroupsVector, plotNamesVector, mode);
     return 0;
   }
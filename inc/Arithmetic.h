@@ -0,0 +1,51 @@
+// Plotting Framework
+//
+// Copyright (C) 2019-2021  Mario Krüger
+// Contact: mario.kruger@cern.ch
+// For a full list of contributors please see docs/Credits
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef Arithmetic_h
+#define Arithmetic_h
+
+#include "Plot.h"
+
+namespace PlottingFramework
+{
+
+//**************************************************************************************************
+/**
+ * Element-wise operations on data points stored in contiguous arrays, including the propagation of
+ * (asymmetric) uncertainties. The first operand is overwritten by the result.
+ * The kernels are free of branches such that the compiler can vectorize them.
+ */
+//**************************************************************************************************
+class Arithmetic
+{
+public:
+  // eyLow and eyHigh may point to the same array for symmetric uncertainties (the mean of lower and upper result uncertainty is stored then),
+  // uncertainties of the second operand may be nullptr
+  static void Apply(operation_t operation, bool isCorrelated, size_t nPoints, double_t* y, double_t* eyLow, double_t* eyHigh,
+                    const double_t* y2, const double_t* eyLow2, const double_t* eyHigh2);
+
+private:
+  template <operation_t operation, bool isCorrelated, bool isSymmetric>
+  static void Kernel(size_t nPoints, double_t* __restrict y, double_t* __restrict eyLow, double_t* __restrict eyHigh,
+                     const double_t* __restrict y2, const double_t* __restrict eyLow2, const double_t* __restrict eyHigh2);
+  template <operation_t operation>
+  static void Dispatch(bool isCorrelated, size_t nPoints, double_t* y, double_t* eyLow, double_t* eyHigh,
+                       const double_t* y2, const double_t* eyLow2, const double_t* eyHigh2);
+};
+
+} // end namespace PlottingFramework
+#endif /* Arithmetic_h */
@@ -0,0 +1,62 @@
+// Plotting Framework
+//
+// Copyright (C) 2019-2021  Mario Krüger
+// Contact: mario.kruger@cern.ch
+// For a full list of contributors please see docs/Credits
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef BoxPlacer_h
+#define BoxPlacer_h
+
+#include "PlottingFramework.h"
+class TPad;
+class TObject;
+
+namespace PlottingFramework
+{
+
+//**************************************************************************************************
+/**
+ * Finds free space in a pad to place legends and text boxes.
+ * All objects drawn in the pad are rasterized once into an occupancy grid. Free positions are then
+ * looked up via the summed-area table of the grid. Placed boxes are marked as occupied such that
+ * subsequent boxes do not overlap with them. All positions and sizes are given in NDC of the pad.
+ */
+//**************************************************************************************************
+class BoxPlacer
+{
+public:
+  BoxPlacer(TPad* pad, double_t marginX, double_t marginY);
+
+  bool FindPosition(double_t width, double_t height, double_t& lowerLeftX, double_t& lowerLeftY);
+  void MarkOccupied(double_t x1, double_t y1, double_t x2, double_t y2);
+
+private:
+  void AddObject(TObject* obj);
+  void MarkUserArea(double_t x1, double_t y1, double_t x2, double_t y2);
+  void MarkUserLine(double_t x1, double_t y1, double_t x2, double_t y2);
+  optional<double_t> ToNDCX(double_t x);
+  optional<double_t> ToNDCY(double_t y);
+  void UpdateSummedAreaTable();
+
+  TPad* mPad;
+  int32_t mNCellsX;
+  int32_t mNCellsY;
+  vector<uint8_t> mGrid;        // occupied cells
+  vector<uint32_t> mSummedArea; // number of occupied cells below and left of each grid point
+  bool mIsSummedAreaUpToDate;
+};
+
+} // end namespace PlottingFramework
+#endif /* BoxPlacer_h */
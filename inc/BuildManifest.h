@@ -0,0 +1,58 @@
+// Plotting Framework
+//
+// Copyright (C) 2019-2021  Mario Krüger
+// Contact: mario.kruger@cern.ch
+// For a full list of contributors please see docs/Credits
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef BuildManifest_h
+#define BuildManifest_h
+
+#include "PlottingFramework.h"
+
+namespace PlottingFramework
+{
+
+//**************************************************************************************************
+/**
+ * Record of the plots saved in the output directory. For every plot it holds the hashes of its
+ * definition and of the input files it was created from as well as the state of the output file,
+ * such that plots can be skipped when none of these changed since the last run.
+ */
+//**************************************************************************************************
+class BuildManifest
+{
+public:
+  BuildManifest(const string& manifestFileName);
+
+  bool IsUpToDate(const string& plotName, size_t definitionHash, size_t inputHash, const string& outputFileName);
+  void Update(const string& plotName, size_t definitionHash, size_t inputHash, const string& outputFileName);
+  void Remove(const string& plotName);
+  void Save();
+
+private:
+  struct manifest_entry_t {
+    size_t definitionHash{};
+    size_t inputHash{};
+    string outputFileName;
+    int64_t modificationTime{};
+    uint64_t fileSize{};
+  };
+
+  string mManifestFileName;
+  unordered_map<string, manifest_entry_t> mEntries; // unique plot name, entry
+  bool mModified;
+};
+
+} // end namespace PlottingFramework
+#endif /* BuildManifest_h */
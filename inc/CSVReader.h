@@ -0,0 +1,64 @@
+// Plotting Framework
+//
+// Copyright (C) 2019-2021  Mario Krüger
+// Contact: mario.kruger@cern.ch
+// For a full list of contributors please see docs/Credits
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef CSVReader_h
+#define CSVReader_h
+
+#include "PlottingFramework.h"
+class TGraph;
+
+namespace PlottingFramework
+{
+
+//**************************************************************************************************
+/**
+ * Format of csv (or tsv) input files. Columns are counted starting from 0.
+ * If any of the asymmetric error columns is specified, a TGraphAsymmErrors is created, otherwise a TGraphErrors.
+ * Whitespace delimiters (tab, blank) treat consecutive delimiters as one.
+ */
+//**************************************************************************************************
+struct csv_format_t {
+  char delimiter{'\t'};
+  char commentChar{'#'};
+  uint32_t nHeaderLines{0u};
+  uint32_t x{0u};
+  uint32_t y{1u};
+  optional<uint32_t> ex{2u};
+  optional<uint32_t> ey{3u};
+  optional<uint32_t> exLow;
+  optional<uint32_t> exHigh;
+  optional<uint32_t> eyLow;
+  optional<uint32_t> eyHigh;
+};
+
+//**************************************************************************************************
+/**
+ * Reader for large csv files. The file is memory-mapped and split into chunks that are parsed in parallel.
+ */
+//**************************************************************************************************
+class CSVReader
+{
+public:
+  static TGraph* ReadGraph(const string& fileName, const csv_format_t& format, uint32_t nThreads = 1u);
+
+private:
+  static void ParseChunk(const char* begin, const char* end, const csv_format_t& format, const vector<int32_t>& slotOfColumn, vector<vector<double_t>>& values, uint64_t& nInvalidLines);
+  static bool ParseNumber(const char* begin, const char* end, double_t& value);
+};
+
+} // end namespace PlottingFramework
+#endif /* CSVReader_h */
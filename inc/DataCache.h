@@ -0,0 +1,73 @@
+// Plotting Framework
+//
+// Copyright (C) 2019-2021  Mario Krüger
+// Contact: mario.kruger@cern.ch
+// For a full list of contributors please see docs/Credits
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef DataCache_h
+#define DataCache_h
+
+#include "PlottingFramework.h"
+#include <memory>
+class TFile;
+class TObject;
+
+namespace PlottingFramework
+{
+
+//**************************************************************************************************
+/**
+ * Persistent on-disk cache for data extracted from input files.
+ * Entries are keyed by input file path, its modification time and size and the path of the data within the file.
+ */
+//**************************************************************************************************
+class DataCache
+{
+public:
+  DataCache(const string& cacheDir, uint64_t maxSizeMB);
+  ~DataCache();
+
+  unordered_map<string, vector<string>> Fetch(const string& inputFileName, const string& suffix, const unordered_map<string, vector<string>>& requiredData, unordered_map<string, std::unique_ptr<TObject>>& loadedData);
+  void Store(const string& inputFileName, const unordered_map<string, vector<string>>& requestedData, const unordered_map<string, std::unique_ptr<TObject>>& loadedData);
+
+private:
+  struct cache_entry_t {
+    string id;
+    int64_t modificationTime{};
+    uint64_t fileSize{};
+    int64_t lastAccess{};
+    uint64_t nBytes{};
+    set<string> storedData;
+    set<string> missingData;
+  };
+
+  cache_entry_t* GetEntry(const string& inputFileName, bool create);
+  TFile* GetCacheFile();
+  void ReadIndex();
+  void WriteIndex();
+  void EnforceSizeLimit();
+  void Compactify();
+
+  static string GetKeyName(const string& dataName);
+
+  string mCacheDir;
+  uint64_t mMaxSize; // in bytes
+  unordered_map<string, cache_entry_t> mEntries; // inputFileName, entry
+  std::unique_ptr<TFile> mCacheFile;
+  bool mIndexModified;
+  bool mRequiresCompactification;
+};
+
+} // end namespace PlottingFramework
+#endif /* DataCache_h */
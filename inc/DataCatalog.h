@@ -0,0 +1,66 @@
+// Plotting Framework
+//
+// Copyright (C) 2019-2021  Mario Krüger
+// Contact: mario.kruger@cern.ch
+// For a full list of contributors please see docs/Credits
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef DataCatalog_h
+#define DataCatalog_h
+
+#include "PlottingFramework.h"
+#include <memory>
+#include <mutex>
+class TObject;
+
+namespace PlottingFramework
+{
+
+//**************************************************************************************************
+/**
+ * Catalog of the data contained in the input files.
+ * For every input file it holds the location (directories, lists and key) of all the data in this file.
+ */
+//**************************************************************************************************
+class DataCatalog
+{
+public:
+  DataCatalog(const string& catalogFileName = "");
+
+  bool MightContain(const string& inputFileName, const unordered_map<string, vector<string>>& requiredData);
+  bool HasEntry(const string& inputFileName);
+  void AddEntry(const string& inputFileName, TObject* folder);
+  optional<string> Locate(const string& inputFileName, const string& path, const string& name);
+  void Save();
+
+private:
+  struct catalog_entry_t {
+    int64_t modificationTime{};
+    uint64_t fileSize{};
+    vector<string> locations;                                // in the order the data would be found by a file traversal
+    unordered_map<string, vector<uint32_t>> locationsByName; // name, indices in locations
+  };
+
+  shared_ptr<const catalog_entry_t> GetEntry(const string& inputFileName);
+  optional<string> Locate(const catalog_entry_t& entry, const string& path, const string& name);
+  static void AddLocations(TObject* folder, const string& prefix, vector<string>& locations);
+  static void IndexLocations(catalog_entry_t& entry);
+
+  string mCatalogFileName;
+  unordered_map<string, shared_ptr<const catalog_entry_t>> mEntries; // inputFileName, entry
+  std::mutex mMutex;
+  bool mModified;
+};
+
+} // end namespace PlottingFramework
+#endif /* DataCatalog_h */
@@ -0,0 +1,55 @@
+// Plotting Framework
+//
+// Copyright (C) 2019-2021  Mario Krüger
+// Contact: mario.kruger@cern.ch
+// For a full list of contributors please see docs/Credits
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef FileWatcher_h
+#define FileWatcher_h
+
+#include "PlottingFramework.h"
+
+namespace PlottingFramework
+{
+
+//**************************************************************************************************
+/**
+ * Watches files for modifications (based on inotify).
+ * The directories containing the files are watched such that also files that are replaced (moved) are detected.
+ */
+//**************************************************************************************************
+class FileWatcher
+{
+public:
+  FileWatcher();
+  ~FileWatcher();
+  FileWatcher(const FileWatcher& other) = delete;
+  FileWatcher& operator=(const FileWatcher& other) = delete;
+
+  bool IsValid() { return mFileDescriptor >= 0; }
+  void AddFile(const string& fileName);
+  set<string> GetChangedFiles(int32_t timeoutMS, int32_t settleTimeMS = 500);
+
+  static string GetNormalizedPath(const string& fileName);
+
+private:
+  bool ReadEvents(int32_t timeoutMS, set<string>& changedFiles);
+
+  int32_t mFileDescriptor;
+  unordered_map<int32_t, string> mDirectories; // watch descriptor, directory
+  set<string> mFiles;
+};
+
+} // end namespace PlottingFramework
+#endif /* FileWatcher_h */
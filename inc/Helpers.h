@@ -25,6 +25,7 @@ namespace PlottingFramework
 string expand_path(const string& path);
 vector<string> split_string(const string& argString, char delimiter);
 bool file_exists(const std::string& name);
+bool get_file_status(const string& name, int64_t& modificationTime, uint64_t& fileSize);
 
 inline bool str_contains(const std::string& str, const std::string& substr)
 {
@@ -0,0 +1,49 @@
+// Plotting Framework
+//
+// Copyright (C) 2019-2021  Mario Krüger
+// Contact: mario.kruger@cern.ch
+// For a full list of contributors please see docs/Credits
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef HistProjector_h
+#define HistProjector_h
+
+#include "PlottingFramework.h"
+#include "Plot.h"
+class TH1;
+class TObject;
+
+namespace PlottingFramework
+{
+
+//**************************************************************************************************
+/**
+ * Creates several projections of a multi-dimensional histogram (THnBase, TH3) in a single pass over its bins.
+ * The projections are filled in parallel, each of them by only one thread.
+ * Projections onto an axis that has a range restriction itself are not supported (nullptr is returned).
+ */
+//**************************************************************************************************
+class HistProjector
+{
+public:
+  using proj_info_t = Plot::Pad::Data::proj_info_t;
+  static vector<TH1*> Project(TObject* data, const vector<const proj_info_t*>& projInfos, uint32_t nThreads = 1u);
+
+private:
+  struct projection_t;
+  static void FillProjection(projection_t& projection, uint64_t nBins, int32_t nDims, const vector<int32_t>& coords, const vector<double_t>& contents, const vector<double_t>& errors2);
+};
+
+} // end namespace PlottingFramework
+#endif /* HistProjector_h */
@@ -56,6 +56,22 @@ enum drawing_options_t : uint8_t {
   cont,
 };
 
+// reduction of large graphs to what can be resolved within the pad
+enum decimation_t : uint8_t {
+  no_decimation = 0,
+  min_max, // first, last, lowest and highest point per pixel column
+  lttb,    // largest triangle three buckets (two points per pixel column)
+};
+
+// element-wise operations of two data (see Plot::Pad::Operation)
+enum operation_t : uint8_t {
+  addition = 0,
+  subtraction,
+  multiplication,
+  division,
+  pull, // difference in units of the uncertainties
+};
+
 //**************************************************************************************************
 /**
  * Class for internal representation of a plot.
@@ -97,24 +113,26 @@ public:
 protected:
   friend class PlotManager;
   friend class PlotPainter;
+  friend class RenderPlan;
 
   inline void SetFigureGroup(const string& figureGroup) { mFigureGroup = figureGroup; }
 
   // accessors for internal use by manager and painter
-  const string& GetName() { return mName; }
-  const string& GetFigureGroup() { return mFigureGroup; }
-  const string& GetFigureCategory() { return mFigureCategory; }
-  const optional<string>& GetPlotTemplateName() { return mPlotTemplateName; }
-  const string& GetUniqueName() { return mUniqueName; }
-  ptree GetPropertyTree();
+  const string& GetName() const { return mName; }
+  const string& GetFigureGroup() const { return mFigureGroup; }
+  const string& GetFigureCategory() const { return mFigureCategory; }
+  const optional<string>& GetPlotTemplateName() const { return mPlotTemplateName; }
+  const string& GetUniqueName() const { return mUniqueName; }
+  ptree GetPropertyTree() const;
 
   auto& GetPads() { return mPads; }
+  const auto& GetPads() const { return mPads; }
 
-  const auto& GetHeight() { return mPlotDimensions.height; }
-  const auto& GetWidth() { return mPlotDimensions.width; }
-  const auto& IsFixAspectRatio() { return mPlotDimensions.fixAspectRatio; }
-  const auto& GetFillColor() { return mFill.color; }
-  const auto& GetFillStyle() { return mFill.style; }
+  const auto& GetHeight() const { return mPlotDimensions.height; }
+  const auto& GetWidth() const { return mPlotDimensions.width; }
+  const auto& IsFixAspectRatio() const { return mPlotDimensions.fixAspectRatio; }
+  const auto& GetFillColor() const { return mFill.color; }
+  const auto& GetFillStyle() const { return mFill.style; }
 
   uint8_t InputDataCount();
 
@@ -150,7 +168,9 @@ class Plot::Pad
 {
 public:
   class Data;
+  class Operation;
   class Ratio;
+  class TreeHistogram;
   class Axis;
   template <class BoxType>
   class Box;
@@ -172,6 +192,16 @@ public:
   Ratio& AddRatio(const string& numeratorName, const Data& data, const string& denominatorName,
                   const string& denominatorInputIdentifier, const string& lable = "");
 
+  Operation& AddOperation(operation_t operation, const string& name, const string& inputIdentifier,
+                          const string& operandName, const string& operandInputIdentifier,
+                          const string& lable = "");
+  Operation& AddOperation(operation_t operation, const string& name, const Data& data, const string& operandName,
+                          const string& operandInputIdentifier, const string& lable = "");
+
+  TreeHistogram& AddTreeHistogram(const string& name, const string& inputIdentifier, const string& treeName,
+                                  const string& expression, int32_t nBins, double_t min, double_t max,
+                                  const string& lable = "");
+
   TextBox& AddText(double_t xPos, double_t yPos, const string& text);
   TextBox& AddText(const string& text);
   LegendBox& AddLegend(double_t xPos, double_t yPos);
@@ -201,6 +231,7 @@ public:
   Pad& SetDefaultDrawingOptionGraph(drawing_options_t drawingOption);
   Pad& SetDefaultDrawingOptionHist(drawing_options_t drawingOption);
   Pad& SetDefaultDrawingOptionHist2d(drawing_options_t drawingOption);
+  Pad& SetDefaultDecimation(decimation_t decimation);
   Pad& SetFill(int16_t color, int16_t style = 1001);
   Pad& SetTransparent();
   Pad& SetFillFrame(int16_t color, int16_t style = 1001);
@@ -212,6 +243,7 @@ public:
 protected:
   friend class PlotManager;
   friend class PlotPainter;
+  friend class RenderPlan;
   friend class Plot;
 
   ptree GetPropertyTree() const;
@@ -219,6 +251,9 @@ protected:
   auto& GetData() { return mData; }
   auto& GetLegendBoxes() { return mLegendBoxes; }
   auto& GetTextBoxes() { return mTextBoxes; }
+  const auto& GetData() const { return mData; }
+  const auto& GetLegendBoxes() const { return mLegendBoxes; }
+  const auto& GetTextBoxes() const { return mTextBoxes; }
 
   const auto& GetAxes() const { return mAxes; }
   const auto& GetTitle() const { return mTitle; }
@@ -253,6 +288,7 @@ protected:
   const auto& GetDefaultDrawingOptionGraph() const { return mDrawingOptionDefaults.graph; }
   const auto& GetDefaultDrawingOptionHist() const { return mDrawingOptionDefaults.hist; }
   const auto& GetDefaultDrawingOptionHist2d() const { return mDrawingOptionDefaults.hist2d; }
+  const auto& GetDefaultDecimation() const { return mDrawingOptionDefaults.decimation; }
   const auto& GetRedrawAxes() const { return mRedrawAxes; }
   const auto& GetRefFunc() const { return mRefFunc; }
 
@@ -294,6 +330,7 @@ private:
     optional<drawing_options_t> graph;
     optional<drawing_options_t> hist;
     optional<drawing_options_t> hist2d;
+    optional<decimation_t> decimation;
   };
 
   // properties
@@ -377,6 +414,8 @@ public:
   virtual Data& SetDefinesFrame();
   virtual Data& SetContours(const vector<double>& contours);
   virtual Data& SetContours(const int32_t nContours);
+  virtual Data& SetDecimation(decimation_t decimation);
+  virtual Data& SetKeepOrder(bool keepOrder = true); // do not sort graphs in x
 
   virtual Data& SetProjectionX(double_t startY = 0, double_t endY = -1, bool isUserCoord = false); // for 2d histos
   virtual Data& SetProjectionY(double_t startX = 0, double_t endX = -1, bool isUserCoord = false); // for 2d histos
@@ -385,7 +424,9 @@ public:
 protected:
   friend class PlotManager;
   friend class PlotPainter;
+  friend class RenderPlan;
   friend class Plot;
+  friend class HistProjector;
 
   virtual std::shared_ptr<Data> Clone() const { return std::make_shared<Data>(*this); }
   virtual ptree GetPropertyTree() const;
@@ -416,6 +457,8 @@ protected:
   const bool& GetDefinesFrame() const { return mDefinesFrame; }
   const auto& GetContours() const { return mContours; }
   const auto& GetNContours() const { return mNContours; }
+  const auto& GetDecimation() const { return mDecimation; }
+  const auto& GetKeepOrder() const { return mKeepOrder; }
   const auto& GetProjInfo() const { return mProjInfo; }
 
   struct proj_info_t {
@@ -428,7 +471,7 @@ protected:
 private:
   bool mDefinesFrame;
 
-  string mType; // for introspection: "data" or "ratio"
+  string mType; // for introspection: "data", "ratio", "operation" or "tree"
   string mName;
   string mInputIdentifier;
 
@@ -462,14 +505,104 @@ private:
 
   optional<vector<double_t>> mContours;
   optional<int32_t> mNContours;
+  optional<decimation_t> mDecimation;
+  optional<bool> mKeepOrder;
+};
+
+//**************************************************************************************************
+/**
+ * Representation of an element-wise operation of two data (first operand: name and inputIdentifier of the data).
+ * Graphs with different x values and histograms with different binning are combined with an interpolation of the second operand.
+ */
+//**************************************************************************************************
+class Plot::Pad::Operation : public Plot::Pad::Data
+{
+public:
+  Operation(operation_t operation, const string& name, const string& inputIdentifier, const string& operandName,
+            const string& operandInputIdentifier, const string& lable);
+  Operation(const ptree& dataTree);
+
+  virtual ~Operation() = default;
+  Operation(const Operation& other) = default;
+  Operation(Operation&&) = default;
+  Operation& operator=(const Operation& other) = default;
+  Operation& operator=(Operation&& other) = default;
+
+  Operation& SetIsCorrelated(bool isCorrelated = true);
+  Operation& SetLayout(const Data& dataLayout) { return static_cast<decltype(*this)&>(Data::SetLayout(dataLayout)); }
+  Operation& SetRangeX(double_t min, double_t max) { return static_cast<decltype(*this)&>(Data::SetRangeX(min, max)); }
+  Operation& SetMaxRangeX(double_t max) { return static_cast<decltype(*this)&>(Data::SetMaxRangeX(max)); }
+  Operation& SetMinRangeX(double_t min) { return static_cast<decltype(*this)&>(Data::SetMinRangeX(min)); }
+  Operation& UnsetRangeX() { return static_cast<decltype(*this)&>(Data::UnsetRangeX()); }
+  Operation& SetRangeY(double_t min, double_t max) { return static_cast<decltype(*this)&>(Data::SetRangeY(min, max)); }
+  Operation& SetMaxRangeY(double_t max) { return static_cast<decltype(*this)&>(Data::SetMaxRangeY(max)); }
+  Operation& SetMinRangeY(double_t min) { return static_cast<decltype(*this)&>(Data::SetMinRangeY(min)); }
+  Operation& UnsetRangeY() { return static_cast<decltype(*this)&>(Data::UnsetRangeY()); }
+  Operation& SetLegendLable(const string& legendLable) { return static_cast<decltype(*this)&>(Data::SetLegendLable(legendLable)); }
+  Operation& SetLegendID(uint8_t legendID) { return static_cast<decltype(*this)&>(Data::SetLegendID(legendID)); }
+  Operation& SetOptions(const string& opions) { return static_cast<decltype(*this)&>(Data::SetOptions(opions)); }
+  Operation& SetOptions(drawing_options_t optionAlias) { return static_cast<decltype(*this)&>(Data::SetOptions(optionAlias)); }
+  Operation& UnsetOptions() { return static_cast<decltype(*this)&>(Data::UnsetOptions()); }
+  Operation& SetTextFormat(const string& textFormat) { return static_cast<decltype(*this)&>(Data::SetTextFormat(textFormat)); }
+  Operation& SetNormalize(bool useWidth = false) { return static_cast<decltype(*this)&>(Data::SetNormalize(useWidth)); }
+  Operation& SetScale(double_t scale) { return static_cast<decltype(*this)&>(Data::SetScaleFactor(scale)); }
+  Operation& SetColor(int16_t color) { return static_cast<decltype(*this)&>(Data::SetColor(color)); }
+  Operation& SetMarker(int16_t color, int16_t style, float_t size) { return static_cast<decltype(*this)&>(Data::SetMarker(color, style, size)); }
+  Operation& SetMarkerColor(int16_t color) { return static_cast<decltype(*this)&>(Data::SetMarkerColor(color)); }
+  Operation& SetMarkerStyle(int16_t style) { return static_cast<decltype(*this)&>(Data::SetMarkerStyle(style)); }
+  Operation& SetMarkerSize(float_t size) { return static_cast<decltype(*this)&>(Data::SetMarkerSize(size)); }
+  Operation& SetLine(int16_t color, int16_t style, float_t width) { return static_cast<decltype(*this)&>(Data::SetLine(color, style, width)); }
+  Operation& SetLineColor(int16_t color) { return static_cast<decltype(*this)&>(Data::SetLineColor(color)); }
+  Operation& SetLineStyle(int16_t style) { return static_cast<decltype(*this)&>(Data::SetLineStyle(style)); }
+  Operation& SetLineWidth(float_t width) { return static_cast<decltype(*this)&>(Data::SetLineWidth(width)); }
+  Operation& SetFill(int16_t color, int16_t style, float_t opacity = 1.) { return static_cast<decltype(*this)&>(Data::SetFill(color, style, opacity)); }
+  Operation& SetFillColor(int16_t color) { return static_cast<decltype(*this)&>(Data::SetFillColor(color)); }
+  Operation& SetFillStyle(int16_t style) { return static_cast<decltype(*this)&>(Data::SetFillStyle(style)); }
+  Operation& SetFillOpacity(float_t opacity) { return static_cast<decltype(*this)&>(Data::SetFillOpacity(opacity)); }
+  Operation& SetDefinesFrame() { return static_cast<decltype(*this)&>(Data::SetDefinesFrame()); }
+  Operation& SetContours(const vector<double>& contours) { return static_cast<decltype(*this)&>(Data::SetContours(contours)); }
+  Operation& SetContours(const int32_t nContours) { return static_cast<decltype(*this)&>(Data::SetContours(nContours)); }
+  Operation& SetDecimation(decimation_t decimation) { return static_cast<decltype(*this)&>(Data::SetDecimation(decimation)); }
+  Operation& SetKeepOrder(bool keepOrder = true) { return static_cast<decltype(*this)&>(Data::SetKeepOrder(keepOrder)); }
+
+  Operation& SetProjectionX(double_t startY = 0, double_t endY = -1, bool isUserCoord = false) { return static_cast<decltype(*this)&>(Data::SetProjectionX(startY, endY, isUserCoord)); }
+  Operation& SetProjectionY(double_t startX = 0, double_t endX = -1, bool isUserCoord = false) { return static_cast<decltype(*this)&>(Data::SetProjectionY(startX, endX, isUserCoord)); }
+  Operation& SetProjection(vector<uint8_t> dims, vector<tuple<uint8_t, double_t, double_t>> ranges, bool isUserCoord = false) { return static_cast<decltype(*this)&>(Data::SetProjection(dims, ranges, isUserCoord)); }
+
+  Operation& SetProjectionXOperand(double_t startY = 0, double_t endY = -1, bool isUserCoord = false);
+  Operation& SetProjectionYOperand(double_t startX = 0, double_t endX = -1, bool isUserCoord = false);
+  Operation& SetProjectionOperand(vector<uint8_t> dims, vector<tuple<uint8_t, double_t, double_t>> ranges, bool isUserCoord = false);
+
+protected:
+  friend class PlotManager;
+  friend class PlotPainter;
+  friend class RenderPlan;
+  friend class Plot;
+
+  virtual std::shared_ptr<Data> Clone() const { return std::make_shared<Operation>(*this); }
+
+  ptree GetPropertyTree() const;
+  const auto& GetOperation() const { return mOperation; }
+  const auto& GetOperandIdentifier() const { return mOperandInputIdentifier; }
+  const auto& GetOperandName() const { return mOperandName; }
+
+  const bool& GetIsCorrelated() const { return mIsCorrelated; }
+  const auto& GetProjInfoOperand() const { return mProjInfoOperand; }
+
+private:
+  operation_t mOperation;
+  string mOperandName;
+  string mOperandInputIdentifier;
+  bool mIsCorrelated;
+  optional<proj_info_t> mProjInfoOperand;
 };
 
 //**************************************************************************************************
 /**
- * Representation of a Ratio.
+ * Representation of a Ratio (division of data by denominator data).
  */
 //**************************************************************************************************
-class Plot::Pad::Ratio : public Plot::Pad::Data
+class Plot::Pad::Ratio : public Plot::Pad::Operation
 {
 public:
   Ratio(const string& name, const string& inputIdentifier, const string& denomName,
@@ -482,12 +615,12 @@ public:
   Ratio& operator=(const Ratio& other) = default;
   Ratio& operator=(Ratio&& other) = default;
 
-  Ratio& SetIsCorrelated(bool isCorrelated = true);
+  Ratio& SetIsCorrelated(bool isCorrelated = true) { return static_cast<decltype(*this)&>(Operation::SetIsCorrelated(isCorrelated)); }
   Ratio& SetLayout(const Data& dataLayout) { return static_cast<decltype(*this)&>(Data::SetLayout(dataLayout)); }
   Ratio& SetRangeX(double_t min, double_t max) { return static_cast<decltype(*this)&>(Data::SetRangeX(min, max)); }
   Ratio& SetMaxRangeX(double_t max) { return static_cast<decltype(*this)&>(Data::SetMaxRangeX(max)); }
   Ratio& SetMinRangeX(double_t min) { return static_cast<decltype(*this)&>(Data::SetMinRangeX(min)); }
-  Ratio& UnsetRangeX() { return static_cast<decltype(*this)&>(Data::UnsetRangeY()); }
+  Ratio& UnsetRangeX() { return static_cast<decltype(*this)&>(Data::UnsetRangeX()); }
   Ratio& SetRangeY(double_t min, double_t max) { return static_cast<decltype(*this)&>(Data::SetRangeY(min, max)); }
   Ratio& SetMaxRangeY(double_t max) { return static_cast<decltype(*this)&>(Data::SetMaxRangeY(max)); }
   Ratio& SetMinRangeY(double_t min) { return static_cast<decltype(*this)&>(Data::SetMinRangeY(min)); }
@@ -516,14 +649,16 @@ public:
   Ratio& SetDefinesFrame() { return static_cast<decltype(*this)&>(Data::SetDefinesFrame()); }
   Ratio& SetContours(const vector<double>& contours) { return static_cast<decltype(*this)&>(Data::SetContours(contours)); }
   Ratio& SetContours(const int32_t nContours) { return static_cast<decltype(*this)&>(Data::SetContours(nContours)); }
+  Ratio& SetDecimation(decimation_t decimation) { return static_cast<decltype(*this)&>(Data::SetDecimation(decimation)); }
+  Ratio& SetKeepOrder(bool keepOrder = true) { return static_cast<decltype(*this)&>(Data::SetKeepOrder(keepOrder)); }
 
   Ratio& SetProjectionX(double_t startY = 0, double_t endY = -1, bool isUserCoord = false) { return static_cast<decltype(*this)&>(Data::SetProjectionX(startY, endY, isUserCoord)); }
   Ratio& SetProjectionY(double_t startX = 0, double_t endX = -1, bool isUserCoord = false) { return static_cast<decltype(*this)&>(Data::SetProjectionY(startX, endX, isUserCoord)); }
   Ratio& SetProjection(vector<uint8_t> dims, vector<tuple<uint8_t, double_t, double_t>> ranges, bool isUserCoord = false) { return static_cast<decltype(*this)&>(Data::SetProjection(dims, ranges, isUserCoord)); }
 
-  Ratio& SetProjectionXDenom(double_t startY = 0, double_t endY = -1, bool isUserCoord = false);
-  Ratio& SetProjectionYDenom(double_t startX = 0, double_t endX = -1, bool isUserCoord = false);
-  Ratio& SetProjectionDenom(vector<uint8_t> dims, vector<tuple<uint8_t, double_t, double_t>> ranges, bool isUserCoord = false);
+  Ratio& SetProjectionXDenom(double_t startY = 0, double_t endY = -1, bool isUserCoord = false) { return static_cast<decltype(*this)&>(Operation::SetProjectionXOperand(startY, endY, isUserCoord)); }
+  Ratio& SetProjectionYDenom(double_t startX = 0, double_t endX = -1, bool isUserCoord = false) { return static_cast<decltype(*this)&>(Operation::SetProjectionYOperand(startX, endX, isUserCoord)); }
+  Ratio& SetProjectionDenom(vector<uint8_t> dims, vector<tuple<uint8_t, double_t, double_t>> ranges, bool isUserCoord = false) { return static_cast<decltype(*this)&>(Operation::SetProjectionOperand(dims, ranges, isUserCoord)); }
 
 protected:
   friend class PlotManager;
@@ -531,19 +666,99 @@ protected:
   friend class Plot;
 
   virtual std::shared_ptr<Data> Clone() const { return std::make_shared<Ratio>(*this); }
+};
 
-  ptree GetPropertyTree() const;
-  const auto& GetDenomIdentifier() const { return mDenomInputIdentifier; }
-  const auto& GetDenomName() const { return mDenomName; }
+//**************************************************************************************************
+/**
+ * Representation of a histogram that is filled from a tree (via RDataFrame) instead of being read from file.
+ * All tree histograms of one input identifier and tree are filled in a single event loop.
+ */
+//**************************************************************************************************
+class Plot::Pad::TreeHistogram : public Plot::Pad::Data
+{
+public:
+  TreeHistogram(const string& name, const string& inputIdentifier, const string& treeName,
+                const string& expression, int32_t nBins, double_t min, double_t max, const string& lable);
+  TreeHistogram(const ptree& dataTree);
+
+  virtual ~TreeHistogram() = default;
+  TreeHistogram(const TreeHistogram& other) = default;
+  TreeHistogram(TreeHistogram&&) = default;
+  TreeHistogram& operator=(const TreeHistogram& other) = default;
+  TreeHistogram& operator=(TreeHistogram&& other) = default;
+
+  TreeHistogram& SetCut(const string& cut);
+  TreeHistogram& SetWeight(const string& weight);
+  TreeHistogram& SetExpressionY(const string& expression, int32_t nBins, double_t min, double_t max); // for 2d histos
+  TreeHistogram& SetLayout(const Data& dataLayout) { return static_cast<decltype(*this)&>(Data::SetLayout(dataLayout)); }
+  TreeHistogram& SetRangeX(double_t min, double_t max) { return static_cast<decltype(*this)&>(Data::SetRangeX(min, max)); }
+  TreeHistogram& SetMaxRangeX(double_t max) { return static_cast<decltype(*this)&>(Data::SetMaxRangeX(max)); }
+  TreeHistogram& SetMinRangeX(double_t min) { return static_cast<decltype(*this)&>(Data::SetMinRangeX(min)); }
+  TreeHistogram& UnsetRangeX() { return static_cast<decltype(*this)&>(Data::UnsetRangeX()); }
+  TreeHistogram& SetRangeY(double_t min, double_t max) { return static_cast<decltype(*this)&>(Data::SetRangeY(min, max)); }
+  TreeHistogram& SetMaxRangeY(double_t max) { return static_cast<decltype(*this)&>(Data::SetMaxRangeY(max)); }
+  TreeHistogram& SetMinRangeY(double_t min) { return static_cast<decltype(*this)&>(Data::SetMinRangeY(min)); }
+  TreeHistogram& UnsetRangeY() { return static_cast<decltype(*this)&>(Data::UnsetRangeY()); }
+  TreeHistogram& SetLegendLable(const string& legendLable) { return static_cast<decltype(*this)&>(Data::SetLegendLable(legendLable)); }
+  TreeHistogram& SetLegendID(uint8_t legendID) { return static_cast<decltype(*this)&>(Data::SetLegendID(legendID)); }
+  TreeHistogram& SetOptions(const string& opions) { return static_cast<decltype(*this)&>(Data::SetOptions(opions)); }
+  TreeHistogram& SetOptions(drawing_options_t optionAlias) { return static_cast<decltype(*this)&>(Data::SetOptions(optionAlias)); }
+  TreeHistogram& UnsetOptions() { return static_cast<decltype(*this)&>(Data::UnsetOptions()); }
+  TreeHistogram& SetTextFormat(const string& textFormat) { return static_cast<decltype(*this)&>(Data::SetTextFormat(textFormat)); }
+  TreeHistogram& SetNormalize(bool useWidth = false) { return static_cast<decltype(*this)&>(Data::SetNormalize(useWidth)); }
+  TreeHistogram& SetScale(double_t scale) { return static_cast<decltype(*this)&>(Data::SetScaleFactor(scale)); }
+  TreeHistogram& SetColor(int16_t color) { return static_cast<decltype(*this)&>(Data::SetColor(color)); }
+  TreeHistogram& SetMarker(int16_t color, int16_t style, float_t size) { return static_cast<decltype(*this)&>(Data::SetMarker(color, style, size)); }
+  TreeHistogram& SetMarkerColor(int16_t color) { return static_cast<decltype(*this)&>(Data::SetMarkerColor(color)); }
+  TreeHistogram& SetMarkerStyle(int16_t style) { return static_cast<decltype(*this)&>(Data::SetMarkerStyle(style)); }
+  TreeHistogram& SetMarkerSize(float_t size) { return static_cast<decltype(*this)&>(Data::SetMarkerSize(size)); }
+  TreeHistogram& SetLine(int16_t color, int16_t style, float_t width) { return static_cast<decltype(*this)&>(Data::SetLine(color, style, width)); }
+  TreeHistogram& SetLineColor(int16_t color) { return static_cast<decltype(*this)&>(Data::SetLineColor(color)); }
+  TreeHistogram& SetLineStyle(int16_t style) { return static_cast<decltype(*this)&>(Data::SetLineStyle(style)); }
+  TreeHistogram& SetLineWidth(float_t width) { return static_cast<decltype(*this)&>(Data::SetLineWidth(width)); }
+  TreeHistogram& SetFill(int16_t color, int16_t style, float_t opacity = 1.) { return static_cast<decltype(*this)&>(Data::SetFill(color, style, opacity)); }
+  TreeHistogram& SetFillColor(int16_t color) { return static_cast<decltype(*this)&>(Data::SetFillColor(color)); }
+  TreeHistogram& SetFillStyle(int16_t style) { return static_cast<decltype(*this)&>(Data::SetFillStyle(style)); }
+  TreeHistogram& SetFillOpacity(float_t opacity) { return static_cast<decltype(*this)&>(Data::SetFillOpacity(opacity)); }
+  TreeHistogram& SetDefinesFrame() { return static_cast<decltype(*this)&>(Data::SetDefinesFrame()); }
+  TreeHistogram& SetContours(const vector<double>& contours) { return static_cast<decltype(*this)&>(Data::SetContours(contours)); }
+  TreeHistogram& SetContours(const int32_t nContours) { return static_cast<decltype(*this)&>(Data::SetContours(nContours)); }
+  TreeHistogram& SetDecimation(decimation_t decimation) { return static_cast<decltype(*this)&>(Data::SetDecimation(decimation)); }
+  TreeHistogram& SetKeepOrder(bool keepOrder = true) { return static_cast<decltype(*this)&>(Data::SetKeepOrder(keepOrder)); }
+  TreeHistogram& SetProjectionX(double_t startY = 0, double_t endY = -1, bool isUserCoord = false) { return static_cast<decltype(*this)&>(Data::SetProjectionX(startY, endY, isUserCoord)); }
+  TreeHistogram& SetProjectionY(double_t startX = 0, double_t endX = -1, bool isUserCoord = false) { return static_cast<decltype(*this)&>(Data::SetProjectionY(startX, endX, isUserCoord)); }
+  TreeHistogram& SetProjection(vector<uint8_t> dims, vector<tuple<uint8_t, double_t, double_t>> ranges, bool isUserCoord = false) { return static_cast<decltype(*this)&>(Data::SetProjection(dims, ranges, isUserCoord)); }
 
-  const bool& GetIsCorrelated() const { return mIsCorrelated; }
-  const auto& GetProjInfoDenom() const { return mProjInfoDenom; }
+protected:
+  friend class PlotManager;
+  friend class PlotPainter;
+  friend class Plot;
+
+  virtual std::shared_ptr<Data> Clone() const { return std::make_shared<TreeHistogram>(*this); }
+
+  ptree GetPropertyTree() const;
+  const auto& GetTreeName() const { return mTreeName; }
+  const auto& GetExpressionX() const { return mAxisX.expression; }
+  const auto& GetNBinsX() const { return mAxisX.nBins; }
+  const auto& GetMinX() const { return mAxisX.min; }
+  const auto& GetMaxX() const { return mAxisX.max; }
+  const auto& GetAxisY() const { return mAxisY; }
+  const auto& GetCut() const { return mCut; }
+  const auto& GetWeight() const { return mWeight; }
+
+  struct tree_axis_t {
+    string expression;
+    int32_t nBins{};
+    double_t min{};
+    double_t max{};
+  };
 
 private:
-  string mDenomName;
-  string mDenomInputIdentifier;
-  bool mIsCorrelated;
-  optional<proj_info_t> mProjInfoDenom;
+  string mTreeName;
+  tree_axis_t mAxisX;
+  optional<tree_axis_t> mAxisY;
+  optional<string> mCut;
+  optional<string> mWeight;
 };
 
 //**************************************************************************************************
@@ -584,6 +799,7 @@ public:
 protected:
   friend class PlotManager;
   friend class PlotPainter;
+  friend class RenderPlan;
   friend class Plot;
 
   Axis(const char axisName);
@@ -19,12 +19,21 @@
 
 #include "PlottingFramework.h"
 #include "Plot.h"
+#include "CSVReader.h"
+#include "TreeReader.h"
+#include "HistProjector.h"
+#include "PlotPainter.h"
+#include <mutex>
 
 class TApplication;
 class TCanvas;
 
 namespace PlottingFramework
 {
+class DataCatalog;
+class DataCache;
+class BuildManifest;
+
 //**************************************************************************************************
 /**
  * Central manager class.
@@ -45,12 +54,23 @@ public:
   void SetOutputDirectory(const string& path);
   void SetUseUniquePlotNames(bool useUniquePlotNames = true);          // if true plot names are set to plotName_IN_figureGroup[.pdf,...]
   void SetOutputFileName(const string& fileName = "ResultPlots.root"); // in case canvases should be saved in .root file
+  void SetUseBuildManifest(bool useBuildManifest = true);              // skip plots that are up to date
+  void SetForceRebuild(bool forceRebuild = true);                      // re-create plots even if they are up to date
 
   // settings related to the input root files
   void AddInputDataFiles(const string& inputIdentifier, const vector<string>& inputFilePathList);
   void AddInputDataFile(const string& inputIdentifier, const string& inputFilePath);
   void DumpInputDataFiles(const string& configFileName); // save input file paths to config file
   void LoadInputDataFiles(const string& configFileName); // load the input file paths from config file
+  void SetNumLoaderThreads(uint32_t nThreads);           // number of threads used to read the input files in parallel
+  void SetCacheDirectory(const string& path);            // enable persistent cache of the data extracted from input files
+  void SetCacheSizeLimit(uint64_t sizeMB);               // maximum size of the data cache
+  void SetUseDataCatalog(bool useDataCatalog = true);    // use catalog of the input file contents to directly access the data
+  void SetUseLazyLoading(bool useLazyLoading = true);    // load input data only when the plot needing them is generated
+  void SetMemoryBudget(uint64_t sizeMB);                 // limit memory occupied by input data (0 = no limit)
+  void SetPrefetchDepth(uint32_t nPlots);                // load data for the next plots in the background while a plot is generated
+  void SetNumRenderProcesses(uint32_t nProcesses);       // number of processes that create and save the plots in parallel
+  void SetCSVFormat(const csv_format_t& format, const string& inputIdentifier = ""); // format of csv input files
 
   // remove all loaded input data (histograms, graphs, ...) from the manager (usually not needed)
   void ClearDataBuffer();
@@ -85,13 +105,17 @@ public:
                   const string& outputMode = "pdf");
   void PrintLoadedPlots();
 
+  // create the plots and keep re-creating those affected by subsequent changes of their input files or definitions
+  void WatchPlots(const string& plotFileName, const vector<string>& figureGroupsWithCategoryUser = {},
+                  const vector<string>& plotNamesUser = {}, const string& outputMode = "pdf");
+
 private:
-  TObject* FindSubDirectory(TObject* folder, vector<string>& subDirs);
   bool GeneratePlot(Plot& plot, const string& outputMode = "pdf");
+  void InitializeGUI();
   ptree& ReadPlotTemplatesFromFile(const string& plotFileName);
   void SavePlotsToFile();
 
-  std::unique_ptr<TApplication> mApp;
+  std::unique_ptr<TApplication> mApp; // only created for interactive mode
   bool mSaveToRootFile;
   string mOutputFileName;
   map<string, shared_ptr<TCanvas>> mPlotLedger;
@@ -101,13 +125,64 @@ private:
   vector<Plot> mPlotTemplates;
   map<string, ptree> mPropertyTreeCache;
   vector<const string*> mPlotViewHistory;
-
-  unordered_map<string, unordered_map<string, std::unique_ptr<TObject>>> mDataBuffer;
+  bool mIsWatching;
+  map<string, ptree> GetPlotDefinitions();
+  const Plot* GetPlotTemplate(const Plot& plot);
+  shared_ptr<const RenderPlan> GetRenderPlan(const Plot& plot);
+  string GetOutputFileName(const Plot& plot, const string& outputMode);
+  size_t GetInputHash(const Plot& plot);
+  string GetBuildManifestFileName();
+  unordered_map<string, shared_ptr<const RenderPlan>> mRenderPlans; // compiled plots by unique name
+
+  using data_buffer_t = unordered_map<string, unordered_map<string, std::unique_ptr<TObject>>>; // inputID, dataName, data
+  data_buffer_t mDataBuffer;
+  projection_cache_t mProjectionCache; // projections of data in the buffer
+  interpolation_cache_t mInterpolationCache; // interpolations of ratio denominators in the buffer (or their projections)
+  map<std::pair<string, string>, vector<Plot::Pad::Data::proj_info_t>> mProjectionRequests; // (inputID, dataName), projections needed by the plots
   map<string, vector<string>> mInputFiles; // inputFileIdentifier, inputFilePaths
-  void PrintBufferStatus(bool missingOnly = false);
+  uint32_t mNumLoaderThreads;
+  string mCacheDirectory;
+  uint64_t mCacheSizeLimit; // in MB
+  std::unique_ptr<DataCache> mDataCache; // opened once per run and written when the run is finished
+  std::mutex mDataCacheMutex;            // the cache is also used by the prefetching thread
+  bool mUseDataCatalog;
+  string mCatalogFileName;
+  std::unique_ptr<DataCatalog> mDataCatalog;
+  bool mUseLazyLoading;
+  uint64_t mMemoryBudget; // in MB
+  uint32_t mPrefetchDepth;
+  uint32_t mNumRenderProcesses;
+  bool mIsPrefetching;
+  bool mUseBuildManifest;
+  bool mForceRebuild;
+  std::unique_ptr<BuildManifest> mBuildManifest;
+  map<std::pair<string, string>, tree_histogram_t> mTreeHistograms; // (inputID, dataName), definition
+  unordered_map<string, csv_format_t> mCSVFormats; // inputIdentifier, format (empty identifier: default)
+  using data_key_t = std::pair<string, string>; // inputID, dataName
+  bool LoadsOnDemand() const { return mUseLazyLoading || mMemoryBudget > 0u || mPrefetchDepth > 0u; }
+  vector<data_key_t> GetRequiredData(const Plot& plot);
+  void RegisterRequiredData(const Plot& plot);
+  void RegisterTreeHistograms(const Plot& plot);
+  TObject* GetData(const string& inputID, const string& dataName, bool loadMissing = true);
+  void SortByRequiredData(vector<Plot*>& plots);
+  void RegisterProjections(const Plot& plot);
+  void ProjectData(const data_key_t& dataKey, TObject* data);
+  void ReleaseProjections(TObject* data);
+  uint64_t ReleaseData(uint32_t plotIndex, map<data_key_t, vector<uint32_t>>& consumers, bool evictUsedData = true);
+  void GeneratePlotsInWorkers(vector<Plot*>& plots, const string& outputMode);
+  void GeneratePlotsWithPrefetch(vector<Plot*>& plots, map<data_key_t, vector<uint32_t>>& consumers, const string& outputMode);
+  static uint64_t EstimateSize(TObject* data);
+  void PrintBufferStatus(bool missingOnly = false, const vector<data_key_t>* dataKeys = nullptr);
   bool FillBuffer();
-  void ReadData(TObject* folder, vector<string>& dataNames, const string& prefix, const string& suffix, const string& inputID);
-  void ReadDataCSV(const string& inputFileName, const string& graphName, const string& inputIdentifier);
+  data_buffer_t LoadData(const vector<data_key_t>& dataKeys);
+  struct load_request_t;
+  void ReadInputFile(const string& fileName, vector<load_request_t*>& requests);
+  static void EraseLoadedData(unordered_map<string, vector<string>>& requiredData, const unordered_map<string, std::unique_ptr<TObject>>& loadedData);
+  struct container_cache_t;
+  TObject* GetContainer(container_cache_t& containers, const string& location);
+  void ReadCatalogedData(const string& inputFileName, container_cache_t& containers, const string& topLocation, const string& suffix, unordered_map<string, vector<string>>& requiredData, unordered_map<string, std::unique_ptr<TObject>>& loadedData);
+  void ReadData(TObject* folder, const string& location, vector<string>& dataNames, const string& prefix, const string& suffix, unordered_map<string, std::unique_ptr<TObject>>& loadedData, container_cache_t& containers);
+  TObject* ReadDataCSV(const string& inputFileName, const string& graphName, const string& inputIdentifier);
 };
 
 } // end namespace PlottingFramework
@@ -18,6 +18,9 @@
 #define PlotGenerator_h
 
 #include "Plot.h"
+#include "RenderPlan.h"
+#include "BoxPlacer.h"
+#include <functional>
 class TH1;
 class TH2;
 class TGraph;
@@ -37,6 +40,48 @@ class TAxis;
 namespace PlottingFramework
 {
 
+// access to input data (inputID, dataName); returns nullptr if data is not available
+using data_getter_t = std::function<TObject*(const string&, const string&)>;
+
+// projections of input data (data, dims, ranges, isUserCoord); entries must be removed together with the data
+using projection_key_t = tuple<TObject*, vector<uint8_t>, vector<tuple<uint8_t, double_t, double_t>>, bool>;
+using projection_cache_t = map<projection_key_t, std::unique_ptr<TObject>>;
+
+// cubic spline through 1d data (knots sorted in x, polynomial coefficients of the segments and uncertainties at the knots)
+struct interpolation_t {
+  vector<double_t> x;
+  vector<double_t> y;
+  vector<double_t> b;
+  vector<double_t> c;
+  vector<double_t> d;
+  vector<double_t> ey;
+};
+// interpolations of input data or their cached projections; entries must be removed together with the data
+using interpolation_cache_t = map<TObject*, shared_ptr<const interpolation_t>>;
+
+// placeholders for properties of the data that can be used in lables, e.g. <mean[.2f]>
+enum class placeholder_t : uint8_t {
+  none = 0, // literal text
+  name,
+  title,
+  entries,
+  integral,
+  integral_visible, // integral within the axis ranges shown in the pad
+  mean,
+  rms,
+  stddev,
+  maximum,
+  minimum,
+  bins,
+  bins_filled,
+};
+// lables parsed into literal text and placeholders (with their fmt format string)
+struct lable_token_t {
+  placeholder_t placeholder{placeholder_t::none};
+  string text;
+};
+using lable_template_t = vector<lable_token_t>;
+
 // supported input data types
 using data_ptr_t = variant<TH1*, TH2*, TGraph*, TGraph2D*, TProfile*, TProfile2D*, TF2*, TF1*>;
 using data_ptr_t_1d = variant<TH1*, TGraph*, TProfile*, TF1*>;
@@ -102,29 +147,52 @@ const map<drawing_options_t, string> defaultDrawingOpions_Graph{
 class PlotPainter
 {
 public:
-  shared_ptr<TCanvas> GeneratePlot(Plot& plot, const unordered_map<string, unordered_map<string, std::unique_ptr<TObject>>>& dataBuffer);
+  PlotPainter(projection_cache_t* projectionCache = nullptr, interpolation_cache_t* interpolationCache = nullptr)
+    : mProjectionCache(projectionCache), mInterpolationCache(interpolationCache) {}
+  ~PlotPainter();
+  PlotPainter(const PlotPainter& other) = delete;
+  PlotPainter& operator=(const PlotPainter& other) = delete;
+
+  // with allowSharedData the input data are drawn directly (instead of a copy) if they are not modified;
+  // the canvas then must be saved before the painter is destroyed
+  shared_ptr<TCanvas> GeneratePlot(const RenderPlan& plan, const data_getter_t& getData, bool allowSharedData = false);
+  static std::tuple<uint64_t, uint64_t> GetTextDimensionsCacheStats(); // hits, misses
 
 private:
-  optional<data_ptr_t> GetDataClone(TObject* obj, const std::optional<Plot::Pad::Data::proj_info_t>& projInfo = std::nullopt);
+  optional<data_ptr_t> GetDataClone(TObject* obj, const std::optional<Plot::Pad::Data::proj_info_t>& projInfo = std::nullopt, bool shareData = false);
   template <typename T>
-  optional<data_ptr_t> GetDataClone(TObject* obj);
+  optional<data_ptr_t> GetDataClone(TObject* obj, bool shareData);
   template <typename T, typename Next, typename... Rest>
-  optional<data_ptr_t> GetDataClone(TObject* obj);
+  optional<data_ptr_t> GetDataClone(TObject* obj, bool shareData);
+  template <typename T>
+  void KeepSharedDataState(T* data_ptr);
+  bool IsModified(const Plot::Pad::Data& data);
   optional<data_ptr_t> GetProjection(TObject* obj, Plot::Pad::Data::proj_info_t projInfo);
+  TObject* GetCachedProjection(TObject* obj, const Plot::Pad::Data::proj_info_t& projInfo);
 
-  void SetGraphRange(TGraph* graph, optional<double_t> min, optional<double_t> max);
+  void SetGraphRange(TGraph* graph, optional<double_t> min, optional<double_t> max, bool keepOrder = false);
+  static set<double_t*> GetPointArrays(TGraph* graph);
+  static void KeepPoints(TGraph* graph, const vector<int32_t>& keptPoints);
+  void DecimateGraph(TGraph* graph, decimation_t decimation, TPad* pad);
   void ScaleGraph(TGraph* graph, double_t scale);
   void SmoothGraph(TGraph* graph, optional<double_t> min = std::nullopt,
                    optional<double_t> = std::nullopt);
   void SmoothHist(TH1* hist, optional<double_t> min = std::nullopt,
                   optional<double_t> max = std::nullopt);
-  bool DivideGraphs(TGraph* numerator, TGraph* denominator);
-  void DivideGraphsInterpolated(TGraph* numerator, TGraph* denominator);
-  void DivideHistosInterpolated(TH1* numerator, TH1* denominator);
-  void DivideHistGraphInterpolated(TH1* numerator, TGraph* denominator);
-  void DivideGraphHistInterpolated(TGraph* numerator, TH1* denominator);
+  template <typename T>
+  void ApplyOperation(TH1* hist, T* operand, operation_t operation, bool isCorrelated, bool isOperandShared);
+  template <typename T>
+  void ApplyOperation(TGraph* graph, T* operand, operation_t operation, bool isCorrelated, bool isOperandShared);
+  static bool HaveSameBinning(TH1* hist1, TH1* hist2);
+  template <typename T>
+  shared_ptr<const interpolation_t> GetInterpolation(T* data, bool isShared = false);
+  static interpolation_t BuildInterpolation(vector<tuple<double_t, double_t, double_t>>& points);
+  static double_t EvalInterpolation(const interpolation_t& interpolation, double_t x, size_t& cursor, double_t& error);
+  static void EvalInterpolation(const interpolation_t& interpolation, const double_t* x, size_t nPoints, double_t* y, double_t* ey);
   std::tuple<uint32_t, uint32_t> GetTextDimensions(TLatex& text);
-  void ReplacePlaceholders(string& str, TNamed* data_ptr);
+  const lable_template_t& GetLableTemplate(const string& lable);
+  string FormatLable(const string& lable, TNamed* data_ptr, TPad* pad);
+  double_t GetStatistic(TH1* hist, placeholder_t placeholder, TPad* pad);
   TPave* GenerateBox(variant<shared_ptr<Plot::Pad::LegendBox>, shared_ptr<Plot::Pad::TextBox>> box,
                      TPad* pad);
   float_t GetTextSizePixel(float_t textsizeNDC);
@@ -134,6 +202,14 @@ private:
   std::string GetAxisStr(int i);
 
   vector<int16_t> GenerateGradientColors(int nColors, const vector<vector<float>>& rgbEndpoints, float_t alpha = 1.);
+
+  projection_cache_t* mProjectionCache;                             // optional cache owned by the caller
+  interpolation_cache_t* mInterpolationCache;                       // optional cache owned by the caller
+  set<TObject*> mSharedData;                                        // input data that are drawn directly
+  map<TPad*, std::unique_ptr<BoxPlacer>> mBoxPlacers;               // free space in the pads for legends and text boxes
+  vector<std::function<void()>> mRestoreActions;                    // undo the layout changes applied to shared data
+  map<tuple<TObject*, TPad*, placeholder_t>, double_t> mStatistics; // statistics of the data used in lables
+  unordered_map<string, lable_template_t> mLableTemplates;          // lables split into text and placeholders
 };
 } // end namespace PlottingFramework
 #endif /* PlotGenerator_h */
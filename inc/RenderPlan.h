@@ -0,0 +1,91 @@
+// Plotting Framework
+//
+// Copyright (C) 2019-2021  Mario Krüger
+// Contact: mario.kruger@cern.ch
+// For a full list of contributors please see docs/Credits
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef RenderPlan_h
+#define RenderPlan_h
+
+#include "Plot.h"
+
+namespace PlottingFramework
+{
+
+//**************************************************************************************************
+/**
+ * Flat representation of a plot combined with its template where all pad defaults and styles are resolved.
+ * A plan is immutable once it is compiled, so the painter only needs to apply it and it can be re-used
+ * as long as the definition of the plot (and its template) does not change.
+ */
+//**************************************************************************************************
+class RenderPlan
+{
+public:
+  RenderPlan(const Plot& plot, const Plot* plotTemplate = nullptr);
+  RenderPlan(const RenderPlan& other) = delete;
+  RenderPlan& operator=(const RenderPlan& other) = delete;
+
+  size_t GetHash() const { return mHash; }
+  static size_t GetHash(const ptree& definition);
+  static ptree GetDefinition(const Plot& plot, const Plot* plotTemplate = nullptr);
+
+protected:
+  friend class PlotManager;
+  friend class PlotPainter;
+
+  struct data_style_t {
+    // drawing options to use if the user did not specify any (depending on the actual data type)
+    string drawingOptionsHist;
+    string drawingOptionsHist2d;
+    string drawingOptionsGraph;
+    Plot::layout_t marker;
+    Plot::layout_t line;
+    Plot::layout_t fill;
+    optional<decimation_t> decimation;
+  };
+  struct pad_style_t {
+    string title;
+    Plot::layout_t text;
+    optional<float_t> marginTop;
+    optional<float_t> marginBottom;
+    optional<float_t> marginLeft;
+    optional<float_t> marginRight;
+    optional<int16_t> fillColor;
+    optional<int16_t> fillStyle;
+    optional<int16_t> frameFillColor;
+    optional<int16_t> frameFillStyle;
+    optional<int16_t> frameLineColor;
+    optional<int16_t> frameLineStyle;
+    optional<float_t> frameLineWidth;
+    optional<int32_t> palette;
+    optional<string> refFunc;
+    bool redrawAxes{};
+    map<char, Plot::Pad::Axis> axes; // pad default axes with the settings of this pad on top
+    vector<data_style_t> data;       // same order as the data of the pad (starting with the axis frame)
+  };
+
+  const Plot& GetPlot() const { return mPlot; }
+  const pad_style_t& GetPadStyle(uint8_t padID) const { return mPadStyles.at(padID); }
+
+private:
+  data_style_t CompileDataStyle(const Plot::Pad::Data& data, uint16_t dataIndex, const Plot::Pad& pad, const Plot::Pad& padDefaults) const;
+
+  Plot mPlot; // deep copy of the plot merged with its template; the axis frame is the first data of each pad
+  map<uint8_t, pad_style_t> mPadStyles;
+  size_t mHash;
+};
+
+} // end namespace PlottingFramework
+#endif /* RenderPlan_h */
@@ -0,0 +1,62 @@
+// Plotting Framework
+//
+// Copyright (C) 2019-2021  Mario Krüger
+// Contact: mario.kruger@cern.ch
+// For a full list of contributors please see docs/Credits
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef TreeReader_h
+#define TreeReader_h
+
+#include "PlottingFramework.h"
+class TH1;
+
+namespace PlottingFramework
+{
+
+//**************************************************************************************************
+/**
+ * Definition of a histogram that is filled from a tree.
+ */
+//**************************************************************************************************
+struct tree_histogram_t {
+  struct axis_t {
+    string expression;
+    int32_t nBins{};
+    double_t min{};
+    double_t max{};
+    bool operator==(const axis_t& other) const { return expression == other.expression && nBins == other.nBins && min == other.min && max == other.max; }
+  };
+  string name;
+  string treeName;
+  axis_t x;
+  optional<axis_t> y;
+  string cut;
+  string weight;
+  bool operator==(const tree_histogram_t& other) const { return name == other.name && treeName == other.treeName && x == other.x && y == other.y && cut == other.cut && weight == other.weight; }
+  bool operator!=(const tree_histogram_t& other) const { return !(*this == other); }
+};
+
+//**************************************************************************************************
+/**
+ * Fills histograms from a tree. All histograms are booked in one RDataFrame such that the tree is read only once.
+ */
+//**************************************************************************************************
+class TreeReader
+{
+public:
+  static vector<TH1*> ReadHistograms(const vector<string>& fileNames, const string& treeName, const vector<const tree_histogram_t*>& histograms, uint32_t nThreads = 1u);
+};
+
+} // end namespace PlottingFramework
+#endif /* TreeReader_h */
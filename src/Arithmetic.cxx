@@ -0,0 +1,163 @@
+// Plotting Framework
+//
+// Copyright (C) 2019-2021  Mario Krüger
+// Contact: mario.kruger@cern.ch
+// For a full list of contributors please see docs/Credits
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "Arithmetic.h"
+
+namespace PlottingFramework
+{
+
+//**************************************************************************************************
+/**
+ * Apply operation to all points. Without uncertainties of the second operand, only the uncertainties of the first operand are propagated.
+ */
+//**************************************************************************************************
+void Arithmetic::Apply(operation_t operation, bool isCorrelated, size_t nPoints, double_t* y, double_t* eyLow, double_t* eyHigh,
+                       const double_t* y2, const double_t* eyLow2, const double_t* eyHigh2)
+{
+  vector<double_t> zeros;
+  if (!eyLow2 || !eyHigh2) {
+    zeros.resize(nPoints);
+    if (!eyLow2) eyLow2 = zeros.data();
+    if (!eyHigh2) eyHigh2 = zeros.data();
+  }
+  switch (operation) {
+    case addition:
+      Dispatch<addition>(isCorrelated, nPoints, y, eyLow, eyHigh, y2, eyLow2, eyHigh2);
+      break;
+    case subtraction:
+      Dispatch<subtraction>(isCorrelated, nPoints, y, eyLow, eyHigh, y2, eyLow2, eyHigh2);
+      break;
+    case multiplication:
+      Dispatch<multiplication>(isCorrelated, nPoints, y, eyLow, eyHigh, y2, eyLow2, eyHigh2);
+      break;
+    case division:
+      Dispatch<division>(isCorrelated, nPoints, y, eyLow, eyHigh, y2, eyLow2, eyHigh2);
+      break;
+    case pull:
+      Dispatch<pull>(isCorrelated, nPoints, y, eyLow, eyHigh, y2, eyLow2, eyHigh2);
+      break;
+  }
+}
+
+//**************************************************************************************************
+/**
+ * Select the kernel matching the properties of the uncertainties.
+ */
+//**************************************************************************************************
+template <operation_t operation>
+void Arithmetic::Dispatch(bool isCorrelated, size_t nPoints, double_t* y, double_t* eyLow, double_t* eyHigh,
+                          const double_t* y2, const double_t* eyLow2, const double_t* eyHigh2)
+{
+  bool isSymmetric = (eyLow == eyHigh);
+  if (isCorrelated) {
+    if (isSymmetric) {
+      Kernel<operation, true, true>(nPoints, y, eyLow, nullptr, y2, eyLow2, eyHigh2);
+    } else {
+      Kernel<operation, true, false>(nPoints, y, eyLow, eyHigh, y2, eyLow2, eyHigh2);
+    }
+  } else {
+    if (isSymmetric) {
+      Kernel<operation, false, true>(nPoints, y, eyLow, nullptr, y2, eyLow2, eyHigh2);
+    } else {
+      Kernel<operation, false, false>(nPoints, y, eyLow, eyHigh, y2, eyLow2, eyHigh2);
+    }
+  }
+}
+
+//**************************************************************************************************
+/**
+ * Element-wise operation. The uncertainties are propagated linearly via the partial derivatives of the operation.
+ * Uncorrelated uncertainties are added in quadrature: the lower uncertainty of the result stems from the lower
+ * uncertainty of an operand that increases the result and from the upper uncertainty of an operand that decreases it.
+ * Fully correlated uncertainties of both operands move in the same direction and are added linearly,
+ * except for the division where the first operand is treated as subset of the second one (binomial uncertainties).
+ * Pulls are the difference of the operands in units of their uncertainties facing each other and have no uncertainty.
+ */
+//**************************************************************************************************
+template <operation_t operation, bool isCorrelated, bool isSymmetric>
+void Arithmetic::Kernel(size_t nPoints, double_t* __restrict y, double_t* __restrict eyLow, double_t* __restrict eyHigh,
+                        const double_t* __restrict y2, const double_t* __restrict eyLow2, const double_t* __restrict eyHigh2)
+{
+  for (size_t i = 0; i < nPoints; ++i) {
+    double_t a = y[i];
+    double_t b = y2[i];
+    double_t aLow = eyLow[i];
+    double_t aHigh = (isSymmetric) ? aLow : eyHigh[i];
+    double_t bLow = eyLow2[i];
+    double_t bHigh = eyHigh2[i];
+
+    double_t value{};
+    double_t resultLow{};
+    double_t resultHigh{};
+    if constexpr (operation == pull) {
+      double_t difference = a - b;
+      double_t aSide = (difference >= 0.) ? aLow : aHigh;
+      double_t bSide = (difference >= 0.) ? bHigh : bLow;
+      double_t sigma = (isCorrelated) ? std::abs(aSide - bSide) : std::sqrt(aSide * aSide + bSide * bSide);
+      // divisions are done unconditionally (with a valid divisor) such that the loop stays free of branches
+      value = difference / ((sigma > 0.) ? sigma : 1.);
+      value = (sigma > 0.) ? value : 0.;
+    } else {
+      double_t derivativeA{};
+      double_t derivativeB{};
+      if constexpr (operation == addition) {
+        value = a + b;
+        derivativeA = 1.;
+        derivativeB = 1.;
+      } else if constexpr (operation == subtraction) {
+        value = a - b;
+        derivativeA = 1.;
+        derivativeB = -1.;
+      } else if constexpr (operation == multiplication) {
+        value = a * b;
+        derivativeA = b;
+        derivativeB = a;
+      } else if constexpr (operation == division) {
+        double_t inverse = 1. / ((b != 0.) ? b : 1.);
+        inverse = (b != 0.) ? inverse : 0.;
+        value = a * inverse;
+        derivativeA = inverse;
+        derivativeB = -value * inverse;
+      }
+
+      if constexpr (isCorrelated && operation == division) {
+        resultLow = std::sqrt(std::abs((1. - 2. * value) * aLow * aLow + value * value * bLow * bLow)) * std::abs(derivativeA);
+        resultHigh = std::sqrt(std::abs((1. - 2. * value) * aHigh * aHigh + value * value * bHigh * bHigh)) * std::abs(derivativeA);
+      } else if constexpr (isCorrelated) {
+        resultLow = std::abs(derivativeA * aLow + derivativeB * bLow);
+        resultHigh = std::abs(derivativeA * aHigh + derivativeB * bHigh);
+      } else {
+        double_t aDown = derivativeA * ((derivativeA >= 0.) ? aLow : aHigh);
+        double_t aUp = derivativeA * ((derivativeA >= 0.) ? aHigh : aLow);
+        double_t bDown = derivativeB * ((derivativeB >= 0.) ? bLow : bHigh);
+        double_t bUp = derivativeB * ((derivativeB >= 0.) ? bHigh : bLow);
+        resultLow = std::sqrt(aDown * aDown + bDown * bDown);
+        resultHigh = std::sqrt(aUp * aUp + bUp * bUp);
+      }
+    }
+
+    y[i] = value;
+    if constexpr (isSymmetric) {
+      eyLow[i] = 0.5 * (resultLow + resultHigh);
+    } else {
+      eyLow[i] = resultLow;
+      eyHigh[i] = resultHigh;
+    }
+  }
+}
+
+} // end namespace PlottingFramework
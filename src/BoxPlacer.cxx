@@ -0,0 +1,236 @@
+// Plotting Framework
+//
+// Copyright (C) 2019-2021  Mario Krüger
+// Contact: mario.kruger@cern.ch
+// For a full list of contributors please see docs/Credits
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "BoxPlacer.h"
+#include "Helpers.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "TPad.h"
+#include "TList.h"
+#include "TH1.h"
+#include "TGraph.h"
+#include "TF1.h"
+#include "TF2.h"
+#include "TPave.h"
+
+namespace PlottingFramework
+{
+// size of the cells of the occupancy grid in pixel
+const int32_t gBoxPlacementCellSize = 4;
+
+//**************************************************************************************************
+/**
+ * Constructor. Rasterizes the area outside of the coordinate system (including the given margins
+ * to the axis ticks) and all objects that are currently drawn in the pad.
+ */
+//**************************************************************************************************
+BoxPlacer::BoxPlacer(TPad* pad, double_t marginX, double_t marginY)
+  : mPad(pad), mIsSummedAreaUpToDate(false)
+{
+  int32_t padWidthPixel = pad->XtoPixel(pad->GetX2());
+  int32_t padHeightPixel = pad->YtoPixel(pad->GetY1());
+  mNCellsX = std::max(1, padWidthPixel / gBoxPlacementCellSize);
+  mNCellsY = std::max(1, padHeightPixel / gBoxPlacementCellSize);
+  mGrid.resize(mNCellsX * mNCellsY, 0u);
+
+  // exclude areas outside of the coordinate system
+  double_t frameX1 = (pad->GetUxmin() - pad->GetX1()) / (pad->GetX2() - pad->GetX1()) + marginX;
+  double_t frameX2 = (pad->GetUxmax() - pad->GetX1()) / (pad->GetX2() - pad->GetX1()) - marginX;
+  double_t frameY1 = (pad->GetUymin() - pad->GetY1()) / (pad->GetY2() - pad->GetY1()) + marginY;
+  double_t frameY2 = (pad->GetUymax() - pad->GetY1()) / (pad->GetY2() - pad->GetY1()) - marginY;
+  MarkOccupied(0., 0., 1., frameY1);
+  MarkOccupied(0., frameY2, 1., 1.);
+  MarkOccupied(0., 0., frameX1, 1.);
+  MarkOccupied(frameX2, 0., 1., 1.);
+
+  for (TObject* obj : *pad->GetListOfPrimitives()) {
+    AddObject(obj);
+  }
+}
+
+//**************************************************************************************************
+/**
+ * Find the left-most (and then lowest) position where a box of the given size does not overlap with any occupied area.
+ */
+//**************************************************************************************************
+bool BoxPlacer::FindPosition(double_t width, double_t height, double_t& lowerLeftX, double_t& lowerLeftY)
+{
+  UpdateSummedAreaTable();
+  int32_t boxCellsX = std::ceil(width * mNCellsX);
+  int32_t boxCellsY = std::ceil(height * mNCellsY);
+  auto getSum = [&](int32_t i, int32_t j) { return mSummedArea[j * (mNCellsX + 1) + i]; };
+  for (int32_t i = 0; i + boxCellsX <= mNCellsX; ++i) {
+    for (int32_t j = 0; j + boxCellsY <= mNCellsY; ++j) {
+      uint32_t nOccupied = getSum(i + boxCellsX, j + boxCellsY) + getSum(i, j) - getSum(i, j + boxCellsY) - getSum(i + boxCellsX, j);
+      if (nOccupied > 0u) continue;
+      lowerLeftX = (double_t)i / mNCellsX;
+      lowerLeftY = (double_t)j / mNCellsY;
+      return true;
+    }
+  }
+  return false;
+}
+
+//**************************************************************************************************
+/**
+ * Mark area as occupied.
+ */
+//**************************************************************************************************
+void BoxPlacer::MarkOccupied(double_t x1, double_t y1, double_t x2, double_t y2)
+{
+  if (std::max(x1, x2) < 0. || std::min(x1, x2) > 1. || std::max(y1, y2) < 0. || std::min(y1, y2) > 1.) return;
+  int32_t i1 = std::clamp<int32_t>(std::floor(std::min(x1, x2) * mNCellsX), 0, mNCellsX - 1);
+  int32_t i2 = std::clamp<int32_t>(std::floor(std::max(x1, x2) * mNCellsX), 0, mNCellsX - 1);
+  int32_t j1 = std::clamp<int32_t>(std::floor(std::min(y1, y2) * mNCellsY), 0, mNCellsY - 1);
+  int32_t j2 = std::clamp<int32_t>(std::floor(std::max(y1, y2) * mNCellsY), 0, mNCellsY - 1);
+  for (int32_t j = j1; j <= j2; ++j) {
+    std::fill(mGrid.begin() + j * mNCellsX + i1, mGrid.begin() + j * mNCellsX + i2 + 1, 1u);
+  }
+  mIsSummedAreaUpToDate = false;
+}
+
+//**************************************************************************************************
+/**
+ * Rasterize object drawn in the pad. Like for the collide grid of ROOT, only 1d histograms, graphs,
+ * functions and boxes are taken into account.
+ */
+//**************************************************************************************************
+void BoxPlacer::AddObject(TObject* obj)
+{
+  string drawingOption = obj->GetDrawOption();
+  std::for_each(drawingOption.begin(), drawingOption.end(), [](char& c) { c = ::toupper(c); });
+
+  if (obj->InheritsFrom(TH1::Class())) {
+    TH1* hist = (TH1*)obj;
+    if (hist->GetDimension() > 1 || str_contains(drawingOption, "AXIS")) return;
+    bool isFilled = (hist->GetFillStyle() != 0);
+    double_t lowerEdge = (mPad->GetLogy()) ? std::pow(10., mPad->GetUymin()) : mPad->GetUymin();
+    for (int32_t bin = 1; bin <= hist->GetNbinsX(); ++bin) {
+      double_t x1 = hist->GetXaxis()->GetBinLowEdge(bin);
+      double_t x2 = hist->GetXaxis()->GetBinUpEdge(bin);
+      double_t y = hist->GetBinContent(bin);
+      double_t error = hist->GetBinError(bin);
+      MarkUserArea(x1, y - error, x2, y + error);
+      if (isFilled) MarkUserArea(x1, lowerEdge, x2, y);
+      if (bin > 1) MarkUserLine(x1, hist->GetBinContent(bin - 1), x1, y);
+    }
+  } else if (obj->InheritsFrom(TGraph::Class())) {
+    TGraph* graph = (TGraph*)obj;
+    bool isLine = str_contains(drawingOption, "L") || str_contains(drawingOption, "C");
+    for (int32_t i = 0; i < graph->GetN(); ++i) {
+      double_t x = graph->GetX()[i];
+      double_t y = graph->GetY()[i];
+      MarkUserArea(x - graph->GetErrorXlow(i), y - graph->GetErrorYlow(i), x + graph->GetErrorXhigh(i), y + graph->GetErrorYhigh(i));
+      if (isLine && i > 0) MarkUserLine(graph->GetX()[i - 1], graph->GetY()[i - 1], x, y);
+    }
+  } else if (obj->InheritsFrom(TF1::Class())) {
+    if (obj->InheritsFrom(TF2::Class())) return;
+    TF1* function = (TF1*)obj;
+    int32_t nPoints = std::max(2, function->GetNpx());
+    double_t step = (function->GetXmax() - function->GetXmin()) / (nPoints - 1);
+    for (int32_t i = 1; i < nPoints; ++i) {
+      double_t x = function->GetXmin() + i * step;
+      MarkUserLine(x - step, function->Eval(x - step), x, function->Eval(x));
+    }
+  } else if (obj->InheritsFrom(TPave::Class())) {
+    TPave* pave = (TPave*)obj;
+    MarkOccupied(pave->GetX1NDC(), pave->GetY1NDC(), pave->GetX2NDC(), pave->GetY2NDC());
+  }
+}
+
+//**************************************************************************************************
+/**
+ * Mark area given in user coordinates as occupied.
+ */
+//**************************************************************************************************
+void BoxPlacer::MarkUserArea(double_t x1, double_t y1, double_t x2, double_t y2)
+{
+  // points outside of the visible range of log axes are moved to the lower edge
+  auto ndcX1 = ToNDCX(x1);
+  auto ndcX2 = ToNDCX(x2);
+  auto ndcY1 = ToNDCY(y1);
+  auto ndcY2 = ToNDCY(y2);
+  if (!ndcX2 || !ndcY2) return;
+  MarkOccupied(ndcX1.value_or(0.), ndcY1.value_or(0.), *ndcX2, *ndcY2);
+}
+
+//**************************************************************************************************
+/**
+ * Mark all cells along a line given in user coordinates as occupied.
+ */
+//**************************************************************************************************
+void BoxPlacer::MarkUserLine(double_t x1, double_t y1, double_t x2, double_t y2)
+{
+  auto ndcX1 = ToNDCX(x1);
+  auto ndcX2 = ToNDCX(x2);
+  auto ndcY1 = ToNDCY(y1);
+  auto ndcY2 = ToNDCY(y2);
+  if (!ndcX1 || !ndcX2 || !ndcY1 || !ndcY2) return;
+  int32_t nSteps = std::ceil(std::max(std::abs(*ndcX2 - *ndcX1) * mNCellsX, std::abs(*ndcY2 - *ndcY1) * mNCellsY)) + 1;
+  nSteps = std::min(nSteps, mNCellsX + mNCellsY);
+  for (int32_t step = 0; step <= nSteps; ++step) {
+    double_t x = *ndcX1 + (*ndcX2 - *ndcX1) * step / nSteps;
+    double_t y = *ndcY1 + (*ndcY2 - *ndcY1) * step / nSteps;
+    MarkOccupied(x, y, x, y);
+  }
+}
+
+//**************************************************************************************************
+/**
+ * Convert user coordinates to NDC of the pad. Returns nothing for values that cannot be shown on log axes.
+ */
+//**************************************************************************************************
+optional<double_t> BoxPlacer::ToNDCX(double_t x)
+{
+  if (mPad->GetLogx()) {
+    if (x <= 0.) return std::nullopt;
+    x = std::log10(x);
+  }
+  return (x - mPad->GetX1()) / (mPad->GetX2() - mPad->GetX1());
+}
+optional<double_t> BoxPlacer::ToNDCY(double_t y)
+{
+  if (mPad->GetLogy()) {
+    if (y <= 0.) return std::nullopt;
+    y = std::log10(y);
+  }
+  return (y - mPad->GetY1()) / (mPad->GetY2() - mPad->GetY1());
+}
+
+//**************************************************************************************************
+/**
+ * Re-calculate the summed-area table after cells were marked as occupied.
+ */
+//**************************************************************************************************
+void BoxPlacer::UpdateSummedAreaTable()
+{
+  if (mIsSummedAreaUpToDate) return;
+  mSummedArea.assign((mNCellsX + 1) * (mNCellsY + 1), 0u);
+  for (int32_t j = 0; j < mNCellsY; ++j) {
+    uint32_t rowSum = 0u;
+    for (int32_t i = 0; i < mNCellsX; ++i) {
+      rowSum += mGrid[j * mNCellsX + i];
+      mSummedArea[(j + 1) * (mNCellsX + 1) + i + 1] = mSummedArea[j * (mNCellsX + 1) + i + 1] + rowSum;
+    }
+  }
+  mIsSummedAreaUpToDate = true;
+}
+
+} // end namespace PlottingFramework
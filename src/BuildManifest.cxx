@@ -0,0 +1,129 @@
+// Plotting Framework
+//
+// Copyright (C) 2019-2021  Mario Krüger
+// Contact: mario.kruger@cern.ch
+// For a full list of contributors please see docs/Credits
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "BuildManifest.h"
+#include "Logging.h"
+#include "Helpers.h"
+
+#include <boost/property_tree/xml_parser.hpp>
+
+namespace PlottingFramework
+{
+
+//**************************************************************************************************
+/**
+ * Constructor. Reads the manifest from manifestFileName in case this file already exists.
+ */
+//**************************************************************************************************
+BuildManifest::BuildManifest(const string& manifestFileName)
+  : mManifestFileName(manifestFileName), mModified(false)
+{
+  if (!file_exists(mManifestFileName)) return;
+  ptree manifestTree;
+  try {
+    using boost::property_tree::read_xml;
+    read_xml(mManifestFileName, manifestTree);
+    for (auto& [key, plotTree] : manifestTree.get_child("MANIFEST", ptree())) {
+      if (key != "PLOT") continue;
+      manifest_entry_t& entry = mEntries[plotTree.get<string>("name")];
+      entry.definitionHash = plotTree.get<size_t>("definitionHash");
+      entry.inputHash = plotTree.get<size_t>("inputHash");
+      entry.outputFileName = plotTree.get<string>("outputFile");
+      entry.modificationTime = plotTree.get<int64_t>("modificationTime");
+      entry.fileSize = plotTree.get<uint64_t>("fileSize");
+    }
+  } catch (...) {
+    WARNING(R"(Cannot read build manifest "{}". All plots will be re-created.)", mManifestFileName);
+    mEntries.clear();
+  }
+}
+
+//**************************************************************************************************
+/**
+ * Check if plot was already created from the same definition and input files and its output file was not touched since.
+ */
+//**************************************************************************************************
+bool BuildManifest::IsUpToDate(const string& plotName, size_t definitionHash, size_t inputHash, const string& outputFileName)
+{
+  auto entryIt = mEntries.find(plotName);
+  if (entryIt == mEntries.end()) return false;
+  const manifest_entry_t& entry = entryIt->second;
+  if (entry.definitionHash != definitionHash || entry.inputHash != inputHash || entry.outputFileName != outputFileName) return false;
+  int64_t modificationTime{};
+  uint64_t fileSize{};
+  if (!get_file_status(outputFileName, modificationTime, fileSize)) return false;
+  return entry.modificationTime == modificationTime && entry.fileSize == fileSize;
+}
+
+//**************************************************************************************************
+/**
+ * Record that plot was created. Plots without output file are removed from the manifest.
+ */
+//**************************************************************************************************
+void BuildManifest::Update(const string& plotName, size_t definitionHash, size_t inputHash, const string& outputFileName)
+{
+  manifest_entry_t entry{definitionHash, inputHash, outputFileName};
+  if (!get_file_status(outputFileName, entry.modificationTime, entry.fileSize)) {
+    Remove(plotName);
+    return;
+  }
+  mEntries[plotName] = entry;
+  mModified = true;
+}
+
+//**************************************************************************************************
+/**
+ * Forget about plot (e.g. because it is about to be re-created).
+ */
+//**************************************************************************************************
+void BuildManifest::Remove(const string& plotName)
+{
+  if (mEntries.erase(plotName)) mModified = true;
+}
+
+//**************************************************************************************************
+/**
+ * Write manifest to disk (only if it was modified).
+ */
+//**************************************************************************************************
+void BuildManifest::Save()
+{
+  if (!mModified) return;
+  ptree manifestTree;
+  for (auto& [plotName, entry] : mEntries) {
+    ptree plotTree;
+    plotTree.put("name", plotName);
+    plotTree.put("definitionHash", entry.definitionHash);
+    plotTree.put("inputHash", entry.inputHash);
+    plotTree.put("outputFile", entry.outputFileName);
+    plotTree.put("modificationTime", entry.modificationTime);
+    plotTree.put("fileSize", entry.fileSize);
+    manifestTree.add_child("MANIFEST.PLOT", plotTree);
+  }
+  using boost::property_tree::xml_writer_settings;
+  xml_writer_settings<std::string> settings('\t', 1);
+  using boost::property_tree::write_xml;
+  try {
+    write_xml(mManifestFileName, manifestTree, std::locale(), settings);
+  } catch (...) {
+    ERROR(R"(Cannot write build manifest "{}".)", mManifestFileName);
+    return;
+  }
+  mModified = false;
+}
+
+} // end namespace PlottingFramework
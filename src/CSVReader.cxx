@@ -0,0 +1,215 @@
+// Plotting Framework
+//
+// Copyright (C) 2019-2021  Mario Krüger
+// Contact: mario.kruger@cern.ch
+// For a full list of contributors please see docs/Credits
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "CSVReader.h"
+#include "Logging.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "TGraphErrors.h"
+#include "TGraphAsymmErrors.h"
+
+namespace PlottingFramework
+{
+// files below this size are not split into chunks
+const uint64_t gMinChunkSizeCSV = 1u << 22;
+
+//**************************************************************************************************
+/**
+ * Read graph from csv file.
+ */
+//**************************************************************************************************
+TGraph* CSVReader::ReadGraph(const string& fileName, const csv_format_t& format, uint32_t nThreads)
+{
+  bool isAsymmetric = format.exLow || format.exHigh || format.eyLow || format.eyHigh;
+  // x, y, errors in the order expected by the graph constructors
+  vector<optional<uint32_t>> columns{format.x, format.y};
+  if (isAsymmetric) {
+    columns.insert(columns.end(), {format.exLow, format.exHigh, format.eyLow, format.eyHigh});
+  } else {
+    columns.insert(columns.end(), {format.ex, format.ey});
+  }
+  vector<int32_t> slotOfColumn;
+  for (size_t slot = 0; slot < columns.size(); ++slot) {
+    if (!columns[slot]) continue;
+    if (slotOfColumn.size() <= *columns[slot]) slotOfColumn.resize(*columns[slot] + 1, -1);
+    slotOfColumn[*columns[slot]] = slot;
+  }
+
+  int fileDescriptor = open(fileName.data(), O_RDONLY);
+  if (fileDescriptor < 0) {
+    ERROR(R"(Input file "{}" not found.)", fileName);
+    return nullptr;
+  }
+  struct stat fileStatus;
+  fstat(fileDescriptor, &fileStatus);
+  uint64_t fileSize = fileStatus.st_size;
+  const char* fileBegin = nullptr;
+  if (fileSize > 0u) {
+    void* mapped = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+    if (mapped == MAP_FAILED) {
+      ERROR(R"(Could not map file "{}" to memory.)", fileName);
+      close(fileDescriptor);
+      return nullptr;
+    }
+    fileBegin = (const char*)mapped;
+    madvise(mapped, fileSize, MADV_SEQUENTIAL);
+  }
+  const char* fileEnd = fileBegin + fileSize;
+
+  // skip header
+  const char* dataBegin = fileBegin;
+  for (uint32_t i = 0u; i < format.nHeaderLines && dataBegin < fileEnd; ++i) {
+    const char* lineEnd = (const char*)memchr(dataBegin, '\n', fileEnd - dataBegin);
+    dataBegin = (lineEnd) ? lineEnd + 1 : fileEnd;
+  }
+
+  // split data into chunks that start at the beginning of a line
+  uint64_t nChunks = std::max<uint64_t>(1u, std::min<uint64_t>(nThreads, (fileEnd - dataBegin) / gMinChunkSizeCSV));
+  vector<const char*> chunkBorders{dataBegin};
+  for (uint64_t i = 1u; i < nChunks; ++i) {
+    const char* border = std::max(chunkBorders.back(), dataBegin + i * (fileEnd - dataBegin) / nChunks);
+    const char* lineEnd = (const char*)memchr(border, '\n', fileEnd - border);
+    chunkBorders.push_back((lineEnd) ? lineEnd + 1 : fileEnd);
+  }
+  chunkBorders.push_back(fileEnd);
+
+  vector<vector<vector<double_t>>> chunkValues(nChunks, vector<vector<double_t>>(columns.size()));
+  vector<uint64_t> nInvalidLines(nChunks, 0u);
+  if (nChunks == 1u) {
+    ParseChunk(chunkBorders[0], chunkBorders[1], format, slotOfColumn, chunkValues[0], nInvalidLines[0]);
+  } else {
+    vector<std::thread> workers;
+    for (uint64_t i = 0u; i < nChunks; ++i) {
+      workers.emplace_back(ParseChunk, chunkBorders[i], chunkBorders[i + 1], std::cref(format), std::cref(slotOfColumn), std::ref(chunkValues[i]), std::ref(nInvalidLines[i]));
+    }
+    for (auto& worker : workers) {
+      worker.join();
+    }
+  }
+  if (fileBegin) munmap((void*)fileBegin, fileSize);
+  close(fileDescriptor);
+
+  // merge chunks
+  vector<vector<double_t>>& values = chunkValues[0];
+  for (uint64_t i = 1u; i < nChunks; ++i) {
+    for (size_t slot = 0; slot < columns.size(); ++slot) {
+      values[slot].insert(values[slot].end(), chunkValues[i][slot].begin(), chunkValues[i][slot].end());
+    }
+    nInvalidLines[0] += nInvalidLines[i];
+  }
+  if (nInvalidLines[0] > 0u) {
+    WARNING(R"(Skipped {} invalid lines in file "{}".)", nInvalidLines[0], fileName);
+  }
+
+  int32_t nPoints = values[0].size();
+  auto getColumn = [&](size_t slot) { return (columns[slot]) ? values[slot].data() : nullptr; };
+  if (isAsymmetric) {
+    return new TGraphAsymmErrors(nPoints, getColumn(0), getColumn(1), getColumn(2), getColumn(3), getColumn(4), getColumn(5));
+  }
+  return new TGraphErrors(nPoints, getColumn(0), getColumn(1), getColumn(2), getColumn(3));
+}
+
+//**************************************************************************************************
+/**
+ * Parse lines within [begin, end) and append the values of the requested columns.
+ */
+//**************************************************************************************************
+void CSVReader::ParseChunk(const char* begin, const char* end, const csv_format_t& format, const vector<int32_t>& slotOfColumn, vector<vector<double_t>>& values, uint64_t& nInvalidLines)
+{
+  bool isWhitespaceDelimiter = (format.delimiter == ' ' || format.delimiter == '\t');
+  auto isBlank = [](char c) { return c == ' ' || c == '\t' || c == '\r'; };
+  vector<bool> isUsedSlot(values.size(), false);
+  for (auto slot : slotOfColumn) {
+    if (slot >= 0) isUsedSlot[slot] = true;
+  }
+  size_t nRequestedSlots = std::count(isUsedSlot.begin(), isUsedSlot.end(), true);
+  size_t nFoundSlots{};
+  vector<double_t> lineValues(values.size());
+
+  const char* lineBegin = begin;
+  while (lineBegin < end) {
+    const char* lineEnd = (const char*)memchr(lineBegin, '\n', end - lineBegin);
+    if (!lineEnd) lineEnd = end;
+    const char* pos = lineBegin;
+    while (pos < lineEnd && isBlank(*pos)) ++pos;
+    if (pos == lineEnd || *pos == format.commentChar) {
+      lineBegin = lineEnd + 1;
+      continue;
+    }
+
+    bool isValid = true;
+    nFoundSlots = 0u;
+    uint32_t column = 0u;
+    while (pos <= lineEnd && isValid) {
+      const char* fieldEnd = pos;
+      while (fieldEnd < lineEnd && *fieldEnd != format.delimiter && !(isWhitespaceDelimiter && isBlank(*fieldEnd))) ++fieldEnd;
+      if (column < slotOfColumn.size() && slotOfColumn[column] >= 0) {
+        const char* fieldBegin = pos;
+        const char* valueEnd = fieldEnd;
+        while (fieldBegin < valueEnd && isBlank(*fieldBegin)) ++fieldBegin;
+        while (valueEnd > fieldBegin && isBlank(*(valueEnd - 1))) --valueEnd;
+        isValid = ParseNumber(fieldBegin, valueEnd, lineValues[slotOfColumn[column]]);
+        ++nFoundSlots;
+      }
+      ++column;
+      if (column >= slotOfColumn.size()) break;
+      pos = fieldEnd + 1;
+      if (isWhitespaceDelimiter) {
+        while (pos < lineEnd && isBlank(*pos)) ++pos;
+      }
+    }
+    if (isValid && nFoundSlots == nRequestedSlots) {
+      for (size_t slot = 0; slot < values.size(); ++slot) {
+        if (isUsedSlot[slot]) values[slot].push_back(lineValues[slot]);
+      }
+    } else {
+      ++nInvalidLines;
+    }
+    lineBegin = lineEnd + 1;
+  }
+}
+
+//**************************************************************************************************
+/**
+ * Parse floating point number in [begin, end).
+ */
+//**************************************************************************************************
+bool CSVReader::ParseNumber(const char* begin, const char* end, double_t& value)
+{
+  if (begin == end) return false;
+  if (*begin == '+') ++begin;
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+  auto [ptr, errorCode] = std::from_chars(begin, end, value);
+  return errorCode == std::errc() && ptr == end;
+#else
+  string number(begin, end);
+  char* ptr = nullptr;
+  value = std::strtod(number.data(), &ptr);
+  return ptr == number.data() + number.size();
+#endif
+}
+
+} // end namespace PlottingFramework
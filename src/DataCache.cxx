@@ -0,0 +1,324 @@
+// Plotting Framework
+//
+// Copyright (C) 2019-2021  Mario Krüger
+// Contact: mario.kruger@cern.ch
+// For a full list of contributors please see docs/Credits
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "DataCache.h"
+#include "Logging.h"
+#include "Helpers.h"
+
+#include <filesystem>
+#include <chrono>
+#include <boost/property_tree/xml_parser.hpp>
+
+#include "TFile.h"
+#include "TKey.h"
+#include "TH1.h"
+
+namespace PlottingFramework
+{
+const string gCacheFileName = "DataCache.root";
+const string gCacheIndexName = "DataCacheIndex.XML";
+
+//**************************************************************************************************
+/**
+ * Constructor for data cache located in cacheDir. The size limit is given in MB.
+ */
+//**************************************************************************************************
+DataCache::DataCache(const string& cacheDir, uint64_t maxSizeMB)
+  : mCacheDir(expand_path(cacheDir)), mMaxSize(maxSizeMB * 1024 * 1024), mIndexModified(false), mRequiresCompactification(false)
+{
+  if (mCacheDir.back() != '/') mCacheDir += "/";
+  ReadIndex();
+}
+
+//**************************************************************************************************
+/**
+ * Destructor. Evicts entries exceeding the size limit and writes the cache index to disk.
+ */
+//**************************************************************************************************
+DataCache::~DataCache()
+{
+  if (!mIndexModified) return;
+  EnforceSizeLimit();
+  if (mRequiresCompactification) Compactify();
+  mCacheFile.reset();
+  WriteIndex();
+}
+
+//**************************************************************************************************
+/**
+ * Fetch data of an input file from the cache. Data found in the cache are added to loadedData.
+ * Returns the data for which the cache has no information and that need to be read from the input file itself.
+ */
+//**************************************************************************************************
+unordered_map<string, vector<string>> DataCache::Fetch(const string& inputFileName, const string& suffix, const unordered_map<string, vector<string>>& requiredData, unordered_map<string, std::unique_ptr<TObject>>& loadedData)
+{
+  cache_entry_t* entry = GetEntry(inputFileName, false);
+  if (!entry) return requiredData;
+  TFile* cacheFile = GetCacheFile();
+  TDirectory* entryDir = (cacheFile) ? cacheFile->GetDirectory(entry->id.data()) : nullptr;
+  if (!entryDir) return requiredData;
+
+  unordered_map<string, vector<string>> unknownData;
+  for (auto& [path, names] : requiredData) {
+    for (auto& name : names) {
+      string fullName = (path.empty()) ? name : path + "/" + name;
+      if (entry->missingData.find(fullName) != entry->missingData.end()) continue;
+      if (entry->storedData.find(fullName) != entry->storedData.end()) {
+        TObject* obj = entryDir->Get(GetKeyName(fullName).data());
+        if (obj) {
+          if (obj->InheritsFrom("TH1")) ((TH1*)obj)->SetDirectory(0); // demand ownership for histogram
+          ((TNamed*)obj)->SetName((fullName + suffix).data());
+          loadedData[fullName].reset(obj);
+          continue;
+        }
+        WARNING(R"(Could not read "{}" of file "{}" from cache.)", fullName, inputFileName);
+        entry->storedData.erase(fullName);
+      }
+      unknownData[path].push_back(name);
+    }
+  }
+  entry->lastAccess = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+  mIndexModified = true;
+  return unknownData;
+}
+
+//**************************************************************************************************
+/**
+ * Store the outcome of reading requestedData from an input file. Data that are not contained in loadedData
+ * are remembered as missing in this file.
+ */
+//**************************************************************************************************
+void DataCache::Store(const string& inputFileName, const unordered_map<string, vector<string>>& requestedData, const unordered_map<string, std::unique_ptr<TObject>>& loadedData)
+{
+  cache_entry_t* entry = GetEntry(inputFileName, true);
+  if (!entry) return;
+  TFile* cacheFile = GetCacheFile();
+  if (!cacheFile) return;
+  TDirectory* entryDir = cacheFile->GetDirectory(entry->id.data());
+  if (!entryDir) entryDir = cacheFile->mkdir(entry->id.data());
+  if (!entryDir) return;
+
+  for (auto& [path, names] : requestedData) {
+    for (auto& name : names) {
+      string fullName = (path.empty()) ? name : path + "/" + name;
+      auto dataIt = loadedData.find(fullName);
+      if (dataIt == loadedData.end() || !dataIt->second) {
+        entry->missingData.insert(fullName);
+        continue;
+      }
+      if (entry->storedData.find(fullName) != entry->storedData.end()) continue;
+      int32_t nBytes = entryDir->WriteTObject(dataIt->second.get(), GetKeyName(fullName).data());
+      if (nBytes <= 0) {
+        WARNING(R"(Could not write "{}" of file "{}" to cache.)", fullName, inputFileName);
+        continue;
+      }
+      entry->nBytes += nBytes;
+      entry->storedData.insert(fullName);
+    }
+  }
+  entry->lastAccess = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+  mIndexModified = true;
+}
+
+//**************************************************************************************************
+/**
+ * Get cache entry corresponding to the current state of the input file.
+ * Entries that belong to an outdated version of the input file are invalidated.
+ */
+//**************************************************************************************************
+DataCache::cache_entry_t* DataCache::GetEntry(const string& inputFileName, bool create)
+{
+  int64_t modificationTime{};
+  uint64_t fileSize{};
+  if (!get_file_status(inputFileName, modificationTime, fileSize)) return nullptr;
+
+  auto entryIt = mEntries.find(inputFileName);
+  if (entryIt != mEntries.end()) {
+    if (entryIt->second.modificationTime == modificationTime && entryIt->second.fileSize == fileSize) {
+      return &entryIt->second;
+    }
+    LOG(R"(Input file "{}" changed. Invalidating its cache entry.)", inputFileName);
+    mEntries.erase(entryIt);
+    mIndexModified = true;
+    mRequiresCompactification = true;
+  }
+  if (!create) return nullptr;
+
+  cache_entry_t& entry = mEntries[inputFileName];
+  std::stringstream id;
+  id << "entry_" << std::hex << std::hash<string>{}(inputFileName + "@" + std::to_string(modificationTime) + "@" + std::to_string(fileSize));
+  entry.id = id.str();
+  entry.modificationTime = modificationTime;
+  entry.fileSize = fileSize;
+  mIndexModified = true;
+  return &entry;
+}
+
+//**************************************************************************************************
+/**
+ * Open the root file containing the cached data.
+ */
+//**************************************************************************************************
+TFile* DataCache::GetCacheFile()
+{
+  if (!mCacheFile) {
+    std::error_code errorCode;
+    std::filesystem::create_directories(mCacheDir, errorCode);
+    mCacheFile.reset(TFile::Open((mCacheDir + gCacheFileName).data(), "UPDATE"));
+    if (!mCacheFile || mCacheFile->IsZombie()) {
+      ERROR(R"(Cannot open data cache in "{}".)", mCacheDir);
+      mCacheFile.reset();
+      mEntries.clear();
+      mIndexModified = false;
+    }
+  }
+  return mCacheFile.get();
+}
+
+//**************************************************************************************************
+/**
+ * Read cache index from disk.
+ */
+//**************************************************************************************************
+void DataCache::ReadIndex()
+{
+  if (!file_exists(mCacheDir + gCacheIndexName) || !file_exists(mCacheDir + gCacheFileName)) return;
+  ptree indexTree;
+  try {
+    using boost::property_tree::read_xml;
+    read_xml(mCacheDir + gCacheIndexName, indexTree);
+  } catch (...) {
+    WARNING(R"(Cannot read data cache index in "{}". Starting with empty cache.)", mCacheDir);
+    mRequiresCompactification = true;
+    return;
+  }
+  for (auto& [key, entryTree] : indexTree.get_child("CACHE", ptree())) {
+    if (key != "ENTRY") continue;
+    cache_entry_t& entry = mEntries[entryTree.get<string>("file")];
+    entry.id = entryTree.get<string>("id");
+    entry.modificationTime = entryTree.get<int64_t>("modificationTime");
+    entry.fileSize = entryTree.get<uint64_t>("fileSize");
+    entry.lastAccess = entryTree.get<int64_t>("lastAccess");
+    entry.nBytes = entryTree.get<uint64_t>("nBytes");
+    for (auto& [dataKey, dataTree] : entryTree) {
+      if (dataKey == "stored") entry.storedData.insert(dataTree.get_value<string>());
+      if (dataKey == "missing") entry.missingData.insert(dataTree.get_value<string>());
+    }
+  }
+}
+
+//**************************************************************************************************
+/**
+ * Write cache index to disk.
+ */
+//**************************************************************************************************
+void DataCache::WriteIndex()
+{
+  ptree indexTree;
+  for (auto& [inputFileName, entry] : mEntries) {
+    ptree entryTree;
+    entryTree.put("file", inputFileName);
+    entryTree.put("id", entry.id);
+    entryTree.put("modificationTime", entry.modificationTime);
+    entryTree.put("fileSize", entry.fileSize);
+    entryTree.put("lastAccess", entry.lastAccess);
+    entryTree.put("nBytes", entry.nBytes);
+    for (auto& dataName : entry.storedData) {
+      entryTree.add("stored", dataName);
+    }
+    for (auto& dataName : entry.missingData) {
+      entryTree.add("missing", dataName);
+    }
+    indexTree.add_child("CACHE.ENTRY", entryTree);
+  }
+  using boost::property_tree::xml_writer_settings;
+  xml_writer_settings<std::string> settings('\t', 1);
+  using boost::property_tree::write_xml;
+  write_xml(mCacheDir + gCacheIndexName, indexTree, std::locale(), settings);
+}
+
+//**************************************************************************************************
+/**
+ * Evict least recently used entries until the cache fits into its size limit.
+ */
+//**************************************************************************************************
+void DataCache::EnforceSizeLimit()
+{
+  uint64_t totalSize = 0u;
+  for (auto& [inputFileName, entry] : mEntries) {
+    totalSize += entry.nBytes;
+  }
+  while (totalSize > mMaxSize && !mEntries.empty()) {
+    auto oldestEntry = std::min_element(mEntries.begin(), mEntries.end(), [](auto& a, auto& b) { return a.second.lastAccess < b.second.lastAccess; });
+    LOG(R"(Evicting cache entry of input file "{}".)", oldestEntry->first);
+    totalSize -= oldestEntry->second.nBytes;
+    mEntries.erase(oldestEntry);
+    mRequiresCompactification = true;
+  }
+}
+
+//**************************************************************************************************
+/**
+ * Rewrite the cache file such that it only contains the entries that are still valid.
+ */
+//**************************************************************************************************
+void DataCache::Compactify()
+{
+  mCacheFile.reset();
+  string cacheFileName = mCacheDir + gCacheFileName;
+  string tmpFileName = cacheFileName + ".tmp";
+  {
+    TFile oldFile(cacheFileName.data(), "READ");
+    TFile newFile(tmpFileName.data(), "RECREATE");
+    if (newFile.IsZombie()) {
+      ERROR(R"(Cannot compactify data cache in "{}".)", mCacheDir);
+      return;
+    }
+    for (auto& [inputFileName, entry] : mEntries) {
+      TDirectory* oldDir = (oldFile.IsZombie()) ? nullptr : oldFile.GetDirectory(entry.id.data());
+      if (!oldDir) {
+        entry.storedData.clear();
+        entry.nBytes = 0u;
+        continue;
+      }
+      TDirectory* newDir = newFile.mkdir(entry.id.data());
+      for (auto keyObj : *oldDir->GetListOfKeys()) {
+        TKey* key = (TKey*)keyObj;
+        std::unique_ptr<TObject> obj(key->ReadObj());
+        if (obj->InheritsFrom("TH1")) ((TH1*)obj.get())->SetDirectory(0);
+        newDir->WriteTObject(obj.get(), key->GetName());
+      }
+    }
+    newFile.Close();
+  }
+  std::filesystem::rename(tmpFileName, cacheFileName);
+  mRequiresCompactification = false;
+}
+
+//**************************************************************************************************
+/**
+ * Key under which data is stored in the cache file. Data paths may contain slashes, which are not allowed in keys.
+ */
+//**************************************************************************************************
+string DataCache::GetKeyName(const string& dataName)
+{
+  std::stringstream keyName;
+  keyName << "data_" << std::hex << std::hash<string>{}(dataName);
+  return keyName.str();
+}
+
+} // end namespace PlottingFramework
@@ -0,0 +1,245 @@
+// Plotting Framework
+//
+// Copyright (C) 2019-2021  Mario Krüger
+// Contact: mario.kruger@cern.ch
+// For a full list of contributors please see docs/Credits
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "DataCatalog.h"
+#include "Logging.h"
+#include "Helpers.h"
+
+#include <boost/property_tree/xml_parser.hpp>
+
+#include "TDirectory.h"
+#include "TFolder.h"
+#include "TCollection.h"
+#include "TKey.h"
+
+namespace PlottingFramework
+{
+
+//**************************************************************************************************
+/**
+ * Constructor. Reads the catalog from catalogFileName in case this file already exists.
+ */
+//**************************************************************************************************
+DataCatalog::DataCatalog(const string& catalogFileName)
+  : mCatalogFileName(catalogFileName), mModified(false)
+{
+  if (mCatalogFileName.empty() || !file_exists(mCatalogFileName)) return;
+  ptree catalogTree;
+  try {
+    using boost::property_tree::read_xml;
+    read_xml(mCatalogFileName, catalogTree);
+  } catch (...) {
+    WARNING(R"(Cannot read data catalog "{}". It will be re-created.)", mCatalogFileName);
+    return;
+  }
+  for (auto& [key, fileTree] : catalogTree.get_child("CATALOG", ptree())) {
+    if (key != "FILE") continue;
+    auto entry = std::make_shared<catalog_entry_t>();
+    entry->modificationTime = fileTree.get<int64_t>("modificationTime");
+    entry->fileSize = fileTree.get<uint64_t>("fileSize");
+    for (auto& [locationKey, locationTree] : fileTree) {
+      if (locationKey == "location") entry->locations.push_back(locationTree.get_value<string>());
+    }
+    IndexLocations(*entry);
+    mEntries[fileTree.get<string>("name")] = entry;
+  }
+}
+
+//**************************************************************************************************
+/**
+ * Write catalog to disk (only if it was modified).
+ */
+//**************************************************************************************************
+void DataCatalog::Save()
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  if (!mModified || mCatalogFileName.empty()) return;
+  ptree catalogTree;
+  for (auto& [inputFileName, entry] : mEntries) {
+    ptree fileTree;
+    fileTree.put("name", inputFileName);
+    fileTree.put("modificationTime", entry->modificationTime);
+    fileTree.put("fileSize", entry->fileSize);
+    for (auto& location : entry->locations) {
+      fileTree.add("location", location);
+    }
+    catalogTree.add_child("CATALOG.FILE", fileTree);
+  }
+  using boost::property_tree::xml_writer_settings;
+  xml_writer_settings<std::string> settings('\t', 1);
+  using boost::property_tree::write_xml;
+  write_xml(mCatalogFileName, catalogTree, std::locale(), settings);
+  mModified = false;
+}
+
+//**************************************************************************************************
+/**
+ * Check if input file may contain any of the required data.
+ * This is always the case if the catalog has no up-to-date information about this file.
+ */
+//**************************************************************************************************
+bool DataCatalog::MightContain(const string& inputFileName, const unordered_map<string, vector<string>>& requiredData)
+{
+  auto entry = GetEntry(inputFileName);
+  if (!entry) return true;
+  for (auto& [path, names] : requiredData) {
+    for (auto& name : names) {
+      if (Locate(*entry, path, name)) return true;
+    }
+  }
+  return false;
+}
+
+//**************************************************************************************************
+/**
+ * Check if catalog has up-to-date information about input file.
+ */
+//**************************************************************************************************
+bool DataCatalog::HasEntry(const string& inputFileName)
+{
+  return GetEntry(inputFileName) != nullptr;
+}
+
+//**************************************************************************************************
+/**
+ * Create catalog entry for input file by traversing its full content starting from folder.
+ */
+//**************************************************************************************************
+void DataCatalog::AddEntry(const string& inputFileName, TObject* folder)
+{
+  auto entry = std::make_shared<catalog_entry_t>();
+  if (!get_file_status(inputFileName, entry->modificationTime, entry->fileSize)) return;
+  LOG(R"(Adding file "{}" to data catalog.)", inputFileName);
+  AddLocations(folder, "", entry->locations);
+  IndexLocations(*entry);
+
+  std::lock_guard<std::mutex> lock(mMutex);
+  mEntries[inputFileName] = entry;
+  mModified = true;
+}
+
+//**************************************************************************************************
+/**
+ * Find location of data (path/name) within input file. The location is given relative to the top level entry point of the file.
+ */
+//**************************************************************************************************
+optional<string> DataCatalog::Locate(const string& inputFileName, const string& path, const string& name)
+{
+  auto entry = GetEntry(inputFileName);
+  if (!entry) return std::nullopt;
+  return Locate(*entry, path, name);
+}
+
+//**************************************************************************************************
+/**
+ * Find location of data (path/name) within catalog entry. The first match in traversal order wins.
+ */
+//**************************************************************************************************
+optional<string> DataCatalog::Locate(const catalog_entry_t& entry, const string& path, const string& name)
+{
+  auto indicesIt = entry.locationsByName.find(name);
+  if (indicesIt == entry.locationsByName.end()) return std::nullopt;
+  string prefix = (path.empty()) ? "" : path + "/";
+  for (auto index : indicesIt->second) {
+    const string& location = entry.locations[index];
+    if (location.compare(0, prefix.size(), prefix) == 0) return location;
+  }
+  return std::nullopt;
+}
+
+//**************************************************************************************************
+/**
+ * Get catalog entry of input file. Entries of files that were modified in the meantime are removed.
+ */
+//**************************************************************************************************
+shared_ptr<const DataCatalog::catalog_entry_t> DataCatalog::GetEntry(const string& inputFileName)
+{
+  int64_t modificationTime{};
+  uint64_t fileSize{};
+  bool fileExists = get_file_status(inputFileName, modificationTime, fileSize);
+
+  std::lock_guard<std::mutex> lock(mMutex);
+  auto entryIt = mEntries.find(inputFileName);
+  if (entryIt == mEntries.end()) return nullptr;
+  if (fileExists && entryIt->second->modificationTime == modificationTime && entryIt->second->fileSize == fileSize) {
+    return entryIt->second;
+  }
+  LOG(R"(Input file "{}" changed. Removing it from data catalog.)", inputFileName);
+  mEntries.erase(entryIt);
+  mModified = true;
+  return nullptr;
+}
+
+//**************************************************************************************************
+/**
+ * Recursively collect locations of all data within folder.
+ * The order corresponds to the one in which PlotManager::ReadData would find the data:
+ * first all data on the current level and only then the content of the sub-structures.
+ */
+//**************************************************************************************************
+void DataCatalog::AddLocations(TObject* folder, const string& prefix, vector<string>& locations)
+{
+  TCollection* itemList = nullptr;
+  if (folder->InheritsFrom("TDirectory")) {
+    itemList = ((TDirectory*)folder)->GetListOfKeys();
+  } else if (folder->InheritsFrom("TFolder")) {
+    itemList = ((TFolder*)folder)->GetListOfFolders();
+  } else if (folder->InheritsFrom("TCollection")) {
+    itemList = (TCollection*)folder;
+  }
+  if (!itemList) return;
+
+  auto isTraversable = [](TObject* item) {
+    if (item->IsA() == TKey::Class()) {
+      string className = ((TKey*)item)->GetClassName();
+      return className.find("TDirectory") != string::npos || className.find("TFolder") != string::npos || className.find("TList") != string::npos || className.find("TObjArray") != string::npos;
+    }
+    return item->InheritsFrom("TDirectory") || item->InheritsFrom("TFolder") || item->InheritsFrom("TCollection");
+  };
+
+  for (auto item : *itemList) {
+    if (!isTraversable(item)) locations.push_back(prefix + item->GetName());
+  }
+  for (auto item : *itemList) {
+    if (!isTraversable(item)) continue;
+    string subPrefix = prefix + item->GetName() + "/";
+    if (item->IsA() == TKey::Class()) {
+      std::unique_ptr<TObject> subFolder(((TKey*)item)->ReadObj());
+      if (!subFolder) continue;
+      if (subFolder->InheritsFrom("TCollection")) ((TCollection*)subFolder.get())->SetOwner();
+      AddLocations(subFolder.get(), subPrefix, locations);
+    } else {
+      AddLocations(item, subPrefix, locations);
+    }
+  }
+}
+
+//**************************************************************************************************
+/**
+ * Build lookup table from data name to its locations.
+ */
+//**************************************************************************************************
+void DataCatalog::IndexLocations(catalog_entry_t& entry)
+{
+  entry.locationsByName.clear();
+  for (uint32_t i = 0; i < entry.locations.size(); ++i) {
+    const string& location = entry.locations[i];
+    entry.locationsByName[location.substr(location.find_last_of('/') + 1)].push_back(i);
+  }
+}
+
+} // end namespace PlottingFramework
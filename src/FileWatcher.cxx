@@ -0,0 +1,146 @@
+// Plotting Framework
+//
+// Copyright (C) 2019-2021  Mario Krüger
+// Contact: mario.kruger@cern.ch
+// For a full list of contributors please see docs/Credits
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "FileWatcher.h"
+#include "Logging.h"
+
+#include <filesystem>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+namespace PlottingFramework
+{
+
+//**************************************************************************************************
+/**
+ * Constructor for FileWatcher.
+ */
+//**************************************************************************************************
+FileWatcher::FileWatcher() : mFileDescriptor(-1)
+{
+#ifdef __linux__
+  mFileDescriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+  if (mFileDescriptor < 0) {
+    ERROR("Watching files is not supported on this system.");
+  }
+}
+
+//**************************************************************************************************
+/**
+ * Destructor for FileWatcher.
+ */
+//**************************************************************************************************
+FileWatcher::~FileWatcher()
+{
+#ifdef __linux__
+  if (mFileDescriptor >= 0) close(mFileDescriptor);
+#endif
+}
+
+//**************************************************************************************************
+/**
+ * Add file to the list of watched files.
+ */
+//**************************************************************************************************
+void FileWatcher::AddFile(const string& fileName)
+{
+  if (!IsValid()) return;
+  string path = GetNormalizedPath(fileName);
+  if (!mFiles.insert(path).second) return;
+
+  string directory = std::filesystem::path(path).parent_path().string();
+  for (auto& [watchDescriptor, watchedDirectory] : mDirectories) {
+    if (watchedDirectory == directory) return;
+  }
+#ifdef __linux__
+  int32_t watchDescriptor = inotify_add_watch(mFileDescriptor, directory.data(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+  if (watchDescriptor < 0) {
+    ERROR(R"(Cannot watch directory "{}".)", directory);
+    return;
+  }
+  mDirectories[watchDescriptor] = directory;
+#endif
+}
+
+//**************************************************************************************************
+/**
+ * Absolute path of file as it is reported for modifications.
+ */
+//**************************************************************************************************
+string FileWatcher::GetNormalizedPath(const string& fileName)
+{
+  std::error_code errorCode;
+  std::filesystem::path path = std::filesystem::absolute(fileName, errorCode);
+  if (errorCode) return fileName;
+  return path.lexically_normal().string();
+}
+
+//**************************************************************************************************
+/**
+ * Wait up to timeoutMS for modifications of the watched files. Once a modification is seen,
+ * further events are collected until no file was touched for settleTimeMS (e.g. while a file is still being written).
+ */
+//**************************************************************************************************
+set<string> FileWatcher::GetChangedFiles(int32_t timeoutMS, int32_t settleTimeMS)
+{
+  set<string> changedFiles;
+  if (!IsValid()) return changedFiles;
+  if (!ReadEvents(timeoutMS, changedFiles)) return changedFiles;
+  while (ReadEvents(settleTimeMS, changedFiles)) {
+  }
+  return changedFiles;
+}
+
+//**************************************************************************************************
+/**
+ * Read pending events. Returns true if any event was received within timeoutMS.
+ */
+//**************************************************************************************************
+bool FileWatcher::ReadEvents(int32_t timeoutMS, set<string>& changedFiles)
+{
+#ifdef __linux__
+  pollfd pollDescriptor{mFileDescriptor, POLLIN, 0};
+  if (poll(&pollDescriptor, 1, timeoutMS) <= 0) return false;
+
+  bool receivedEvents = false;
+  alignas(inotify_event) char buffer[4096];
+  ssize_t length;
+  while ((length = read(mFileDescriptor, buffer, sizeof(buffer))) > 0) {
+    for (char* pos = buffer; pos < buffer + length;) {
+      inotify_event* event = (inotify_event*)pos;
+      pos += sizeof(inotify_event) + event->len;
+      auto directoryIt = mDirectories.find(event->wd);
+      if (event->len == 0 || directoryIt == mDirectories.end()) continue;
+      string fileName = directoryIt->second + "/" + event->name;
+      if (mFiles.find(fileName) != mFiles.end()) {
+        changedFiles.insert(fileName);
+        receivedEvents = true;
+      }
+    }
+  }
+  return receivedEvents;
+#else
+  return false;
+#endif
+}
+
+} // end namespace PlottingFramework
@@ -16,6 +16,7 @@
 
 #include "Helpers.h"
 #include <sys/stat.h>
+#include <filesystem>
 
 namespace PlottingFramework
 {
@@ -45,4 +46,17 @@ bool file_exists(const std::string& name)
   return (stat(name.c_str(), &buffer) == 0);
 }
 
+bool get_file_status(const string& name, int64_t& modificationTime, uint64_t& fileSize)
+{
+  // ignore sub-folder specifications (file.root:dir)
+  string fileName = split_string(name, ':')[0];
+  std::error_code errorCode;
+  auto fileTime = std::filesystem::last_write_time(fileName, errorCode);
+  if (errorCode) return false;
+  fileSize = std::filesystem::file_size(fileName, errorCode);
+  if (errorCode) return false;
+  modificationTime = fileTime.time_since_epoch().count();
+  return true;
+}
+
 } // end namespace PlottingFramework
@@ -0,0 +1,265 @@
+// Plotting Framework
+//
+// Copyright (C) 2019-2021  Mario Krüger
+// Contact: mario.kruger@cern.ch
+// For a full list of contributors please see docs/Credits
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "HistProjector.h"
+
+#include <algorithm>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "TH1.h"
+#include "TH2.h"
+#include "TH3.h"
+#include "THnBase.h"
+
+namespace PlottingFramework
+{
+// number of bins that are decoded at once before they are distributed to the projections
+const uint64_t gProjectionBlockSize = 1u << 20;
+
+//**************************************************************************************************
+/**
+ * Projection that is filled from the bins of the source histogram.
+ */
+//**************************************************************************************************
+struct HistProjector::projection_t {
+  vector<int32_t> dims;                          // source dimensions of the output axes
+  vector<std::pair<int32_t, int32_t>> binRanges; // accepted bins in each source dimension
+  int32_t nCellsX{};                             // number of bins in x including under- and overflow
+  vector<double_t> contents;
+  vector<double_t> errors2;
+  TH1* hist{};
+};
+
+//**************************************************************************************************
+/**
+ * Create the projections of data. The histograms are returned in the order of the requests.
+ */
+//**************************************************************************************************
+vector<TH1*> HistProjector::Project(TObject* data, const vector<const proj_info_t*>& projInfos, uint32_t nThreads)
+{
+  vector<TH1*> histograms(projInfos.size(), nullptr);
+  vector<TAxis*> axes;
+  std::function<double_t(Long64_t, int32_t*, double_t&)> getBin; // content, coordinates and squared error of bin
+  Long64_t nBins{};
+  bool hasErrors{};
+  if (data->InheritsFrom(THnBase::Class())) {
+    THnBase* hist = (THnBase*)data;
+    for (int32_t i = 0; i < hist->GetNdimensions(); ++i) {
+      axes.push_back(hist->GetAxis(i));
+    }
+    nBins = hist->GetNbins();
+    hasErrors = hist->GetCalculateErrors();
+    getBin = [hist](Long64_t bin, int32_t* coord, double_t& error2) {
+      error2 = hist->GetBinError2(bin);
+      return hist->GetBinContent(bin, coord);
+    };
+  } else if (data->InheritsFrom(TH3::Class())) {
+    TH3* hist = (TH3*)data;
+    axes = {hist->GetXaxis(), hist->GetYaxis(), hist->GetZaxis()};
+    nBins = hist->GetNcells();
+    hasErrors = (hist->GetSumw2N() > 0);
+    getBin = [hist](Long64_t bin, int32_t* coord, double_t& error2) {
+      hist->GetBinXYZ(bin, coord[0], coord[1], coord[2]);
+      double_t error = hist->GetBinError(bin);
+      error2 = error * error;
+      return hist->GetBinContent(bin);
+    };
+  } else {
+    return histograms;
+  }
+  int32_t nDims = axes.size();
+
+  // book the output histograms with the binning of the projected axes
+  auto isValidDim = [nDims](int32_t dim) { return dim >= 0 && dim < nDims; };
+  vector<projection_t> projections;
+  vector<uint32_t> requestIndices;
+  bool addDirStatus = TH1::AddDirectoryStatus();
+  TH1::AddDirectory(false);
+  for (uint32_t i = 0; i < projInfos.size(); ++i) {
+    const proj_info_t& projInfo = *projInfos[i];
+    projection_t projection;
+    projection.dims.assign(projInfo.dims.begin(), projInfo.dims.end());
+    if (projection.dims.empty() || projection.dims.size() > 2 || !std::all_of(projection.dims.begin(), projection.dims.end(), isValidDim)) continue;
+    if (projection.dims.size() == 2 && projection.dims[0] == projection.dims[1]) continue;
+
+    bool isSupported = true;
+    for (auto axis : axes) {
+      projection.binRanges.push_back({0, axis->GetNbins() + 1});
+    }
+    for (auto& [rangeDim, min, max] : projInfo.ranges) {
+      if (!isValidDim(rangeDim) || std::find(projection.dims.begin(), projection.dims.end(), rangeDim) != projection.dims.end()) {
+        isSupported = false;
+        break;
+      }
+      // let the axis interpret the range in the same way as for the projections done by ROOT
+      TAxis* axis = axes[rangeDim];
+      int32_t minBin = (projInfo.isUserCoord) ? axis->FindBin(min) : static_cast<int32_t>(min);
+      int32_t maxBin = (projInfo.isUserCoord) ? axis->FindBin(max) : static_cast<int32_t>(max);
+      axis->SetRange(minBin, maxBin);
+      if (axis->TestBit(TAxis::kAxisRange)) {
+        projection.binRanges[rangeDim] = {axis->GetFirst(), axis->GetLast()};
+      } else {
+        projection.binRanges[rangeDim] = {0, axis->GetNbins() + 1};
+      }
+      axis->SetRange();
+    }
+    if (!isSupported) continue;
+
+    string name = string(data->GetName()) + projInfo.GetNameSuffix();
+    TAxis* axisX = axes[projection.dims[0]];
+    if (projection.dims.size() == 1) {
+      if (axisX->GetXbins()->GetSize()) {
+        projection.hist = new TH1D(name.data(), data->GetTitle(), axisX->GetNbins(), axisX->GetXbins()->GetArray());
+      } else {
+        projection.hist = new TH1D(name.data(), data->GetTitle(), axisX->GetNbins(), axisX->GetXmin(), axisX->GetXmax());
+      }
+    } else {
+      TAxis* axisY = axes[projection.dims[1]];
+      if (axisX->GetXbins()->GetSize() || axisY->GetXbins()->GetSize()) {
+        vector<double_t> edgesX, edgesY;
+        for (int32_t bin = 1; bin <= axisX->GetNbins() + 1; ++bin) {
+          edgesX.push_back(axisX->GetBinLowEdge(bin));
+        }
+        for (int32_t bin = 1; bin <= axisY->GetNbins() + 1; ++bin) {
+          edgesY.push_back(axisY->GetBinLowEdge(bin));
+        }
+        projection.hist = new TH2D(name.data(), data->GetTitle(), axisX->GetNbins(), edgesX.data(), axisY->GetNbins(), edgesY.data());
+      } else {
+        projection.hist = new TH2D(name.data(), data->GetTitle(), axisX->GetNbins(), axisX->GetXmin(), axisX->GetXmax(), axisY->GetNbins(), axisY->GetXmin(), axisY->GetXmax());
+      }
+      projection.hist->GetYaxis()->SetTitle(axisY->GetTitle());
+    }
+    projection.hist->GetXaxis()->SetTitle(axisX->GetTitle());
+    if (hasErrors) projection.hist->Sumw2();
+    projection.nCellsX = axisX->GetNbins() + 2;
+    projection.contents.resize(projection.hist->GetNcells(), 0.);
+    if (hasErrors) projection.errors2.resize(projection.hist->GetNcells(), 0.);
+    projections.push_back(std::move(projection));
+    requestIndices.push_back(i);
+  }
+  TH1::AddDirectory(addDirStatus);
+  if (projections.empty()) return histograms;
+
+  // decode a block of bins and let each thread add them to its share of the projections
+  // (the worker threads are started once, the calling thread decodes the blocks and fills the first share)
+  nThreads = std::max<uint32_t>(1u, std::min<uint32_t>(nThreads, projections.size()));
+  vector<int32_t> coords(gProjectionBlockSize * nDims);
+  vector<double_t> contents(gProjectionBlockSize);
+  vector<double_t> errors2(gProjectionBlockSize);
+  auto fillProjections = [&](uint32_t thread, uint64_t nBinsInBlock) {
+    for (uint32_t i = thread; i < projections.size(); i += nThreads) {
+      FillProjection(projections[i], nBinsInBlock, nDims, coords, contents, errors2);
+    }
+  };
+
+  std::mutex mutex;
+  std::condition_variable condition;
+  uint64_t blockID{};      // increased once the next block is decoded
+  uint64_t nBinsInBlock{}; // number of decoded bins in the current block
+  uint32_t nBusyWorkers{};
+  bool isFinished{false};
+  vector<std::thread> workers;
+  for (uint32_t thread = 1u; thread < nThreads; ++thread) {
+    workers.emplace_back([&, thread]() {
+      uint64_t filledBlockID{};
+      while (true) {
+        uint64_t nBinsToFill{};
+        {
+          std::unique_lock<std::mutex> lock(mutex);
+          condition.wait(lock, [&]() { return isFinished || blockID != filledBlockID; });
+          if (isFinished) return;
+          filledBlockID = blockID;
+          nBinsToFill = nBinsInBlock;
+        }
+        fillProjections(thread, nBinsToFill);
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--nBusyWorkers == 0u) condition.notify_all();
+      }
+    });
+  }
+
+  for (Long64_t blockBegin = 0; blockBegin < nBins; blockBegin += gProjectionBlockSize) {
+    Long64_t blockEnd = std::min<Long64_t>(nBins, blockBegin + gProjectionBlockSize);
+    uint64_t nDecodedBins = 0u;
+    for (Long64_t bin = blockBegin; bin < blockEnd; ++bin) {
+      double_t error2{};
+      double_t content = getBin(bin, &coords[nDecodedBins * nDims], error2);
+      if (content == 0. && error2 == 0.) continue;
+      contents[nDecodedBins] = content;
+      errors2[nDecodedBins] = error2;
+      ++nDecodedBins;
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      nBinsInBlock = nDecodedBins;
+      nBusyWorkers = workers.size();
+      ++blockID;
+    }
+    condition.notify_all();
+    fillProjections(0u, nDecodedBins);
+    // the buffers can only be re-used once all workers are done with the block
+    std::unique_lock<std::mutex> lock(mutex);
+    condition.wait(lock, [&]() { return nBusyWorkers == 0u; });
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    isFinished = true;
+  }
+  condition.notify_all();
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  for (uint32_t i = 0; i < projections.size(); ++i) {
+    projection_t& projection = projections[i];
+    for (int32_t bin = 0; bin < (int32_t)projection.contents.size(); ++bin) {
+      projection.hist->SetBinContent(bin, projection.contents[bin]);
+      if (hasErrors) projection.hist->SetBinError(bin, std::sqrt(projection.errors2[bin]));
+    }
+    projection.hist->ResetStats();
+    histograms[requestIndices[i]] = projection.hist;
+  }
+  return histograms;
+}
+
+//**************************************************************************************************
+/**
+ * Add the decoded bins that are within the ranges of the projection.
+ */
+//**************************************************************************************************
+void HistProjector::FillProjection(projection_t& projection, uint64_t nBins, int32_t nDims, const vector<int32_t>& coords, const vector<double_t>& contents, const vector<double_t>& errors2)
+{
+  bool hasErrors = !projection.errors2.empty();
+  for (uint64_t i = 0u; i < nBins; ++i) {
+    const int32_t* coord = &coords[i * nDims];
+    bool isInRange = true;
+    for (int32_t dim = 0; dim < nDims && isInRange; ++dim) {
+      isInRange = (coord[dim] >= projection.binRanges[dim].first && coord[dim] <= projection.binRanges[dim].second);
+    }
+    if (!isInRange) continue;
+    int32_t bin = coord[projection.dims[0]];
+    if (projection.dims.size() == 2) bin += projection.nCellsX * coord[projection.dims[1]];
+    projection.contents[bin] += contents[i];
+    if (hasErrors) projection.errors2[bin] += errors2[i];
+  }
+}
+
+} // end namespace PlottingFramework
@@ -101,7 +101,7 @@ Plot::Plot(const ptree& plotTree)
  * Get representation of plot as property tree.
  */
 //**************************************************************************************************
-ptree Plot::GetPropertyTree()
+ptree Plot::GetPropertyTree() const
 {
   ptree plotTree;
   plotTree.put("name", mName);
@@ -414,6 +414,17 @@ auto Plot::Pad::SetDefaultDrawingOptionHist2d(drawing_options_t drawingOption) -
   return *this;
 }
 
+//**************************************************************************************************
+/**
+ * Set default decimation of large graphs.
+ */
+//**************************************************************************************************
+auto Plot::Pad::SetDefaultDecimation(decimation_t decimation) -> decltype(*this)
+{
+  mDrawingOptionDefaults.decimation = decimation;
+  return *this;
+}
+
 //**************************************************************************************************
 /**
  * Set fill for this pad.
@@ -579,6 +590,7 @@ Plot::Pad::Pad(const ptree& padTree)
   read_from_tree(padTree, mDrawingOptionDefaults.graph, "default_drawing_option_graph");
   read_from_tree(padTree, mDrawingOptionDefaults.hist, "default_drawing_option_hist");
   read_from_tree(padTree, mDrawingOptionDefaults.hist2d, "default_drawing_option_hist2d");
+  read_from_tree(padTree, mDrawingOptionDefaults.decimation, "default_decimation");
   read_from_tree(padTree, mRedrawAxes, "redraw_axes");
   read_from_tree(padTree, mRefFunc, "ref_func");
 
@@ -592,6 +604,12 @@ Plot::Pad::Pad(const ptree& padTree)
       if (type == "ratio") {
         mData.push_back(std::make_shared<Ratio>(content.second));
       }
+      if (type == "operation") {
+        mData.push_back(std::make_shared<Operation>(content.second));
+      }
+      if (type == "tree") {
+        mData.push_back(std::make_shared<TreeHistogram>(content.second));
+      }
     }
     // add boxes
     if (str_contains(content.first, "LEGEND")) {
@@ -650,6 +668,7 @@ ptree Plot::Pad::GetPropertyTree() const
   put_in_tree(padTree, mDrawingOptionDefaults.graph, "default_drawing_option_graph");
   put_in_tree(padTree, mDrawingOptionDefaults.hist, "default_drawing_option_hist");
   put_in_tree(padTree, mDrawingOptionDefaults.hist2d, "default_drawing_option_hist2d");
+  put_in_tree(padTree, mDrawingOptionDefaults.decimation, "default_decimation");
   put_in_tree(padTree, mRedrawAxes, "redraw_axes");
   put_in_tree(padTree, mRefFunc, "ref_func");
 
@@ -718,6 +737,7 @@ void Plot::Pad::operator+=(const Pad& pad)
   if (pad.mDrawingOptionDefaults.graph) mDrawingOptionDefaults.graph = pad.mDrawingOptionDefaults.graph;
   if (pad.mDrawingOptionDefaults.hist) mDrawingOptionDefaults.hist = pad.mDrawingOptionDefaults.hist;
   if (pad.mDrawingOptionDefaults.hist2d) mDrawingOptionDefaults.hist2d = pad.mDrawingOptionDefaults.hist2d;
+  if (pad.mDrawingOptionDefaults.decimation) mDrawingOptionDefaults.decimation = pad.mDrawingOptionDefaults.decimation;
   if (pad.mPalette) mPalette = pad.mPalette;
   if (pad.mRedrawAxes) mRedrawAxes = pad.mRedrawAxes;
   if (pad.mRefFunc) mRefFunc = pad.mRefFunc;
@@ -838,6 +858,35 @@ Plot::Pad::Ratio& Plot::Pad::AddRatio(const string& numeratorName, const Data& d
   return *std::dynamic_pointer_cast<Ratio>(mData.back());
 }
 
+//**************************************************************************************************
+/**
+ * Add element-wise operation of two data to this pad.
+ */
+//**************************************************************************************************
+Plot::Pad::Operation& Plot::Pad::AddOperation(operation_t operation, const string& name, const string& inputIdentifier, const string& operandName, const string& operandInputIdentifier, const string& lable)
+{
+  mData.push_back(std::make_shared<Operation>(operation, name, inputIdentifier, operandName, operandInputIdentifier, lable));
+  return *std::dynamic_pointer_cast<Operation>(mData.back());
+}
+
+Plot::Pad::Operation& Plot::Pad::AddOperation(operation_t operation, const string& name, const Data& data, const string& operandName, const string& operandInputIdentifier, const string& lable)
+{
+  mData.push_back(std::make_shared<Operation>(operation, name, data.GetInputID(), operandName, operandInputIdentifier, lable));
+  mData.back()->SetLayout(data);
+  return *std::dynamic_pointer_cast<Operation>(mData.back());
+}
+
+//**************************************************************************************************
+/**
+ * Add histogram filled from a tree to this pad.
+ */
+//**************************************************************************************************
+Plot::Pad::TreeHistogram& Plot::Pad::AddTreeHistogram(const string& name, const string& inputIdentifier, const string& treeName, const string& expression, int32_t nBins, double_t min, double_t max, const string& lable)
+{
+  mData.push_back(std::make_shared<TreeHistogram>(name, inputIdentifier, treeName, expression, nBins, min, max, lable));
+  return *std::dynamic_pointer_cast<TreeHistogram>(mData.back());
+}
+
 //**************************************************************************************************
 /**
  * Add text box to this pad.
@@ -949,6 +998,8 @@ Plot::Pad::Data::Data(const ptree& dataTree) : Data()
   read_from_tree(dataTree, mRangeY.max, "rangeY_max");
   read_from_tree(dataTree, mContours, "contours");
   read_from_tree(dataTree, mNContours, "number_of_contours");
+  read_from_tree(dataTree, mDecimation, "decimation");
+  read_from_tree(dataTree, mKeepOrder, "keep_order");
 
   // ugly workaround
   std::optional<vector<uint8_t>> dims;
@@ -997,6 +1048,8 @@ ptree Plot::Pad::Data::GetPropertyTree() const
   put_in_tree(dataTree, mRangeY.max, "rangeY_max");
   put_in_tree(dataTree, mContours, "contours");
   put_in_tree(dataTree, mNContours, "number_of_contours");
+  put_in_tree(dataTree, mDecimation, "decimation");
+  put_in_tree(dataTree, mKeepOrder, "keep_order");
 
   // ugly workaround
   if (mProjInfo) {
@@ -1034,6 +1087,8 @@ auto Plot::Pad::Data::SetLayout(const Data& dataLayout) -> decltype(*this)
   mFill.scale = dataLayout.mFill.scale;
   mContours = dataLayout.mContours;
   mNContours = dataLayout.mNContours;
+  mDecimation = dataLayout.mDecimation;
+  mKeepOrder = dataLayout.mKeepOrder;
   return *this;
 }
 auto Plot::Pad::Data::SetInputID(const string& inputIdentifier) -> decltype(*this)
@@ -1219,6 +1274,16 @@ auto Plot::Pad::Data::SetContours(const int32_t nContours) -> decltype(*this)
   mNContours = nContours;
   return *this;
 }
+auto Plot::Pad::Data::SetDecimation(decimation_t decimation) -> decltype(*this)
+{
+  mDecimation = decimation;
+  return *this;
+}
+auto Plot::Pad::Data::SetKeepOrder(bool keepOrder) -> decltype(*this)
+{
+  mKeepOrder = keepOrder;
+  return *this;
+}
 auto Plot::Pad::Data::SetProjectionX(double_t startY, double_t endY, bool isUserCoord) -> decltype(*this)
 {
   mProjInfo = {{0}, {{1, startY, endY}}, isUserCoord};
@@ -1267,7 +1332,7 @@ std::string Plot::Pad::Data::proj_info_t::GetNameSuffix() const
 
 //--------------------------------------------------------------------------------------------------
 //--------------------------------------------------------------------------------------------------
-// IMPLEMENTATION class Ratio
+// IMPLEMENTATION class Operation
 //--------------------------------------------------------------------------------------------------
 //--------------------------------------------------------------------------------------------------
 
@@ -1276,19 +1341,19 @@ std::string Plot::Pad::Data::proj_info_t::GetNameSuffix() const
  * Default constructor.
  */
 //**************************************************************************************************
-Plot::Pad::Ratio::Ratio(const string& name, const string& inputIdentifier, const string& denomName,
-                        const string& denomInputIdentifier, const string& lable)
-  : Data(name, inputIdentifier, lable), mDenomName(denomName),
-    mDenomInputIdentifier(denomInputIdentifier), mIsCorrelated(false)
+Plot::Pad::Operation::Operation(operation_t operation, const string& name, const string& inputIdentifier, const string& operandName,
+                                const string& operandInputIdentifier, const string& lable)
+  : Data(name, inputIdentifier, lable), mOperation(operation), mOperandName(operandName),
+    mOperandInputIdentifier(operandInputIdentifier), mIsCorrelated(false)
 {
-  SetType("ratio");
+  SetType("operation");
 
-  // in case denominator input was specified further via denomInputIdentifier:some/path/in/file
-  auto subPathPos = denomInputIdentifier.find(":");
+  // in case operand input was specified further via operandInputIdentifier:some/path/in/file
+  auto subPathPos = operandInputIdentifier.find(":");
   if (subPathPos != string::npos) {
     // prepend path to plot name
-    mDenomName = denomInputIdentifier.substr(subPathPos + 1) + "/" + denomName;
-    mDenomInputIdentifier = denomInputIdentifier.substr(0, subPathPos);
+    mOperandName = operandInputIdentifier.substr(subPathPos + 1) + "/" + operandName;
+    mOperandInputIdentifier = operandInputIdentifier.substr(0, subPathPos);
   }
 }
 
@@ -1297,46 +1362,54 @@ Plot::Pad::Ratio::Ratio(const string& name, const string& inputIdentifier, const
  * Constructor from property tree.
  */
 //**************************************************************************************************
-Plot::Pad::Ratio::Ratio(const ptree& dataTree) : Data(dataTree)
+Plot::Pad::Operation::Operation(const ptree& dataTree) : Data(dataTree), mOperation(division), mIsCorrelated(false)
 {
+  bool isRatio = (GetType() == "ratio"); // ratios keep their original keys
+  string operandKey = (isRatio) ? "denom" : "operand";
+  string projKey = (isRatio) ? "projDenom" : "projOperand";
   try {
-    mDenomName = dataTree.get<string>("denomName");
-    mDenomInputIdentifier = dataTree.get<string>("denomInputID");
+    if (!isRatio) mOperation = static_cast<operation_t>(dataTree.get<uint16_t>("operation"));
+    mOperandName = dataTree.get<string>(operandKey + "Name");
+    mOperandInputIdentifier = dataTree.get<string>(operandKey + "InputID");
     mIsCorrelated = dataTree.get<bool>("isCorrelated");
   } catch (...) {
-    ERROR("Could not construct ratio from ptree.");
+    ERROR("Could not construct {} from ptree.", GetType());
   }
 
   // ugly workaround
   std::optional<vector<uint8_t>> dims;
   std::optional<vector<std::tuple<uint8_t, double_t, double_t>>> ranges;
   std::optional<bool> isUserCoord;
-  read_from_tree(dataTree, dims, "projDenom_dims");
-  read_from_tree(dataTree, ranges, "projDenom_ranges");
-  read_from_tree(dataTree, isUserCoord, "projDenom_isUserCoord");
+  read_from_tree(dataTree, dims, projKey + "_dims");
+  read_from_tree(dataTree, ranges, projKey + "_ranges");
+  read_from_tree(dataTree, isUserCoord, projKey + "_isUserCoord");
 
   if (dims) {
-    mProjInfoDenom = {*dims, *ranges, *isUserCoord};
+    mProjInfoOperand = {*dims, *ranges, *isUserCoord};
   }
 }
 
 //**************************************************************************************************
 /**
- * Convert ratio to property tree.
+ * Convert operation to property tree.
  */
 //**************************************************************************************************
-ptree Plot::Pad::Ratio::GetPropertyTree() const
+ptree Plot::Pad::Operation::GetPropertyTree() const
 {
   ptree dataTree = Data::GetPropertyTree();
-  dataTree.put("denomName", mDenomName);
-  dataTree.put("denomInputID", mDenomInputIdentifier);
+  bool isRatio = (GetType() == "ratio"); // ratios keep their original keys
+  string operandKey = (isRatio) ? "denom" : "operand";
+  string projKey = (isRatio) ? "projDenom" : "projOperand";
+  if (!isRatio) dataTree.put("operation", static_cast<uint16_t>(mOperation));
+  dataTree.put(operandKey + "Name", mOperandName);
+  dataTree.put(operandKey + "InputID", mOperandInputIdentifier);
   dataTree.put("isCorrelated", mIsCorrelated);
 
   // ugly workaround
-  if (mProjInfo) {
-    put_in_tree(dataTree, std::optional<vector<uint8_t>>{(*mProjInfoDenom).dims}, "projDenom_dims");
-    put_in_tree(dataTree, std::optional<vector<std::tuple<uint8_t, double_t, double_t>>>{(*mProjInfoDenom).ranges}, "projDenom_ranges");
-    put_in_tree(dataTree, std::optional<bool>{(*mProjInfoDenom).isUserCoord}, "projDenom_isUserCoord");
+  if (mProjInfoOperand) {
+    put_in_tree(dataTree, std::optional<vector<uint8_t>>{(*mProjInfoOperand).dims}, projKey + "_dims");
+    put_in_tree(dataTree, std::optional<vector<std::tuple<uint8_t, double_t, double_t>>>{(*mProjInfoOperand).ranges}, projKey + "_ranges");
+    put_in_tree(dataTree, std::optional<bool>{(*mProjInfoOperand).isUserCoord}, projKey + "_isUserCoord");
   }
 
   return dataTree;
@@ -1344,28 +1417,145 @@ ptree Plot::Pad::Ratio::GetPropertyTree() const
 
 //**************************************************************************************************
 /**
- * Specify how the division should be done (spline, biniomial, etc...).
+ * Specify if the uncertainties of the operands are correlated.
+ * For divisions this means the numerator is a subset of the denominator (binomial uncertainties),
+ * for all other operations the uncertainties are assumed to be fully correlated.
  */
 //**************************************************************************************************
-auto Plot::Pad::Ratio::SetIsCorrelated(bool isCorrelated) -> decltype(*this)
+auto Plot::Pad::Operation::SetIsCorrelated(bool isCorrelated) -> decltype(*this)
 {
   mIsCorrelated = isCorrelated;
   return *this;
 }
 
-auto Plot::Pad::Ratio::SetProjectionXDenom(double_t startY, double_t endY, bool isUserCoord) -> decltype(*this)
+auto Plot::Pad::Operation::SetProjectionXOperand(double_t startY, double_t endY, bool isUserCoord) -> decltype(*this)
+{
+  mProjInfoOperand = {{0}, {{1, startY, endY}}, isUserCoord};
+  return *this;
+}
+auto Plot::Pad::Operation::SetProjectionYOperand(double_t startX, double_t endX, bool isUserCoord) -> decltype(*this)
 {
-  mProjInfoDenom = {{0}, {{1, startY, endY}}, isUserCoord};
+  mProjInfoOperand = {{1}, {{0, startX, endX}}, isUserCoord};
   return *this;
 }
-auto Plot::Pad::Ratio::SetProjectionYDenom(double_t startX, double_t endX, bool isUserCoord) -> decltype(*this)
+auto Plot::Pad::Operation::SetProjectionOperand(vector<uint8_t> dims, vector<tuple<uint8_t, double_t, double_t>> ranges, bool isUserCoord) -> decltype(*this)
 {
-  mProjInfoDenom = {{1}, {{0, startX, endX}}, isUserCoord};
+  mProjInfoOperand = {dims, ranges, isUserCoord};
   return *this;
 }
-auto Plot::Pad::Ratio::SetProjectionDenom(vector<uint8_t> dims, vector<tuple<uint8_t, double_t, double_t>> ranges, bool isUserCoord) -> decltype(*this)
+
+//--------------------------------------------------------------------------------------------------
+//--------------------------------------------------------------------------------------------------
+// IMPLEMENTATION class Ratio
+//--------------------------------------------------------------------------------------------------
+//--------------------------------------------------------------------------------------------------
+
+//**************************************************************************************************
+/**
+ * Default constructor.
+ */
+//**************************************************************************************************
+Plot::Pad::Ratio::Ratio(const string& name, const string& inputIdentifier, const string& denomName,
+                        const string& denomInputIdentifier, const string& lable)
+  : Operation(division, name, inputIdentifier, denomName, denomInputIdentifier, lable)
+{
+  SetType("ratio");
+}
+
+//**************************************************************************************************
+/**
+ * Constructor from property tree.
+ */
+//**************************************************************************************************
+Plot::Pad::Ratio::Ratio(const ptree& dataTree) : Operation(dataTree) {}
+
+//--------------------------------------------------------------------------------------------------
+//--------------------------------------------------------------------------------------------------
+// IMPLEMENTATION class TreeHistogram
+//--------------------------------------------------------------------------------------------------
+//--------------------------------------------------------------------------------------------------
+
+//**************************************************************************************************
+/**
+ * Default constructor.
+ */
+//**************************************************************************************************
+Plot::Pad::TreeHistogram::TreeHistogram(const string& name, const string& inputIdentifier, const string& treeName,
+                                        const string& expression, int32_t nBins, double_t min, double_t max, const string& lable)
+  : Data(name, inputIdentifier, lable), mTreeName(treeName), mAxisX{expression, nBins, min, max}
+{
+  SetType("tree");
+}
+
+//**************************************************************************************************
+/**
+ * Constructor from property tree.
+ */
+//**************************************************************************************************
+Plot::Pad::TreeHistogram::TreeHistogram(const ptree& dataTree) : Data(dataTree)
+{
+  try {
+    mTreeName = dataTree.get<string>("tree");
+    mAxisX = {dataTree.get<string>("expressionX"), dataTree.get<int32_t>("nBinsX"), dataTree.get<double_t>("minX"), dataTree.get<double_t>("maxX")};
+    if (auto expressionY = dataTree.get_optional<string>("expressionY")) {
+      mAxisY = {*expressionY, dataTree.get<int32_t>("nBinsY"), dataTree.get<double_t>("minY"), dataTree.get<double_t>("maxY")};
+    }
+  } catch (...) {
+    ERROR("Could not construct tree histogram from ptree.");
+  }
+  read_from_tree(dataTree, mCut, "cut");
+  read_from_tree(dataTree, mWeight, "weight");
+}
+
+//**************************************************************************************************
+/**
+ * Convert tree histogram to property tree.
+ */
+//**************************************************************************************************
+ptree Plot::Pad::TreeHistogram::GetPropertyTree() const
+{
+  ptree dataTree = Data::GetPropertyTree();
+  dataTree.put("tree", mTreeName);
+  dataTree.put("expressionX", mAxisX.expression);
+  dataTree.put("nBinsX", mAxisX.nBins);
+  dataTree.put("minX", mAxisX.min);
+  dataTree.put("maxX", mAxisX.max);
+  if (mAxisY) {
+    dataTree.put("expressionY", mAxisY->expression);
+    dataTree.put("nBinsY", mAxisY->nBins);
+    dataTree.put("minY", mAxisY->min);
+    dataTree.put("maxY", mAxisY->max);
+  }
+  put_in_tree(dataTree, mCut, "cut");
+  put_in_tree(dataTree, mWeight, "weight");
+  return dataTree;
+}
+
+//**************************************************************************************************
+/**
+ * Only fill entries passing the selection (expression evaluated on the tree).
+ */
+//**************************************************************************************************
+auto Plot::Pad::TreeHistogram::SetCut(const string& cut) -> decltype(*this)
+{
+  mCut = cut;
+  return *this;
+}
+
+auto Plot::Pad::TreeHistogram::SetWeight(const string& weight) -> decltype(*this)
+{
+  mWeight = weight;
+  return *this;
+}
+
+//**************************************************************************************************
+/**
+ * Make this a 2d histogram with the given expression and binning on the y axis.
+ */
+//**************************************************************************************************
+auto Plot::Pad::TreeHistogram::SetExpressionY(const string& expression, int32_t nBins, double_t min, double_t max) -> decltype(*this)
 {
-  mProjInfoDenom = {dims, ranges, isUserCoord};
+  mAxisY = {expression, nBins, min, max};
   return *this;
 }
 
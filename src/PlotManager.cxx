@@ -17,12 +17,25 @@
 // framework dependencies
 #include "PlotManager.h"
 #include "PlotPainter.h"
+#include "DataCache.h"
+#include "DataCatalog.h"
+#include "FileWatcher.h"
+#include "BuildManifest.h"
 #include "Logging.h"
 #include "Helpers.h"
 
 // std dependencies
 #include <regex>
 #include <filesystem>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <cstdio>
+#include <cerrno>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/wait.h>
 
 // boost dependencies
 #include <boost/property_tree/xml_parser.hpp>
@@ -33,11 +46,15 @@
 #include "TSystem.h"
 #include "TError.h"
 #include "TFile.h"
-#include "TRootCanvas.h"
+#include "TCanvasImp.h"
+#include "TClass.h"
 #include "TCanvas.h"
 #include "TKey.h"
 #include "TH1.h"
 #include "TGraphErrors.h"
+#include "TGraphAsymmErrors.h"
+#include "TGraph2D.h"
+#include "THnBase.h"
 #include "TFolder.h"
 
 namespace PlottingFramework
@@ -48,9 +65,8 @@ namespace PlottingFramework
  * Constructor for PlotManager.
  */
 //**************************************************************************************************
-PlotManager::PlotManager() : mApp(new TApplication("MainApp", 0, nullptr)), mSaveToRootFile(false), mOutputFileName("ResultPlots.root"), mUseUniquePlotNames(false)
+PlotManager::PlotManager() : mSaveToRootFile(false), mOutputFileName("ResultPlots.root"), mUseUniquePlotNames(false), mIsWatching(false), mNumLoaderThreads(1), mCacheSizeLimit(2048), mUseDataCatalog(false), mUseLazyLoading(false), mMemoryBudget(0), mPrefetchDepth(0), mNumRenderProcesses(1), mIsPrefetching(false), mUseBuildManifest(false), mForceRebuild(false), mCSVFormats{{"", csv_format_t{}}}
 {
-  TQObject::Connect("TGMainFrame", "CloseWindow()", "TApplication", gApplication, "Terminate()");
   gErrorIgnoreLevel = kWarning;
 }
 
@@ -62,6 +78,21 @@ PlotManager::PlotManager() : mApp(new TApplication("MainApp", 0, nullptr)), mSav
 PlotManager::~PlotManager()
 {
   if (mSaveToRootFile) SavePlotsToFile();
+  auto [textCacheHits, textCacheMisses] = PlotPainter::GetTextDimensionsCacheStats();
+  if (textCacheHits + textCacheMisses > 0u) LOG("Text dimensions cache: {} hits, {} misses.", textCacheHits, textCacheMisses);
+}
+
+//**************************************************************************************************
+/**
+ * Set up the graphical environment that is needed to show plots in windows.
+ */
+//**************************************************************************************************
+void PlotManager::InitializeGUI()
+{
+  if (mApp) return;
+  gROOT->SetBatch(kFALSE);
+  mApp.reset(new TApplication("MainApp", 0, nullptr));
+  TQObject::Connect("TGMainFrame", "CloseWindow()", "TApplication", gApplication, "Terminate()");
 }
 
 //**************************************************************************************************
@@ -102,6 +133,8 @@ void PlotManager::SavePlotsToFile()
 //**************************************************************************************************
 void PlotManager::ClearDataBuffer()
 {
+  mInterpolationCache.clear();
+  mProjectionCache.clear();
   mDataBuffer.clear();
 };
 
@@ -115,6 +148,28 @@ void PlotManager::SetOutputDirectory(const string& path)
 {
   mOutputDirectory = path;
 }
+//**************************************************************************************************
+/**
+ * Keep track of the created plots in a manifest next to the output directory and skip plots
+ * whose definition, input files and output file did not change since they were last created.
+ */
+//**************************************************************************************************
+void PlotManager::SetUseBuildManifest(bool useBuildManifest)
+{
+  mUseBuildManifest = useBuildManifest;
+  if (!mUseBuildManifest) mBuildManifest.reset();
+}
+
+//**************************************************************************************************
+/**
+ * Re-create all plots even if they are up to date according to the build manifest.
+ */
+//**************************************************************************************************
+void PlotManager::SetForceRebuild(bool forceRebuild)
+{
+  mForceRebuild = forceRebuild;
+}
+
 void PlotManager::SetUseUniquePlotNames(bool useUniquePlotNames)
 {
   mUseUniquePlotNames = useUniquePlotNames;
@@ -184,11 +239,11 @@ void PlotManager::LoadInputDataFiles(const string& configFileName)
     set<string> allFileNames;
     for (auto& fileEntry : inputPair.second) {
       string fileOrDirName = expand_path(fileEntry.second.get_value<string>());
-      if (fileOrDirName.rfind(".root") != string::npos || fileOrDirName.rfind(".csv") != string::npos) {
+      if (fileOrDirName.rfind(".root") != string::npos || fileOrDirName.rfind(".csv") != string::npos || fileOrDirName.rfind(".tsv") != string::npos) {
         allFileNames.insert(fileOrDirName);
       } else if (std::filesystem::is_directory(fileOrDirName)) {
         for (auto& file : std::filesystem::recursive_directory_iterator(fileOrDirName)) {
-          if (file.path().extension() == ".root" || file.path().extension() == ".csv") {
+          if (file.path().extension() == ".root" || file.path().extension() == ".csv" || file.path().extension() == ".tsv") {
             allFileNames.insert(file.path().string());
           }
         }
@@ -196,6 +251,117 @@ void PlotManager::LoadInputDataFiles(const string& configFileName)
     }
     AddInputDataFiles(inputIdentifier, {allFileNames.begin(), allFileNames.end()});
   }
+  // the data catalog is kept next to the config file
+  string catalogFileName = std::filesystem::path(expand_path(configFileName)).replace_extension(".catalog.XML").string();
+  if (catalogFileName != mCatalogFileName) {
+    mCatalogFileName = catalogFileName;
+    mDataCatalog.reset();
+  }
+}
+
+//**************************************************************************************************
+/**
+ * Set number of threads that are used to read the input files. With more than one thread, all files
+ * belonging to the required input identifiers are opened in parallel. The result is identical to
+ * the sequential mode: for each input identifier the first file (in the user defined order)
+ * containing the data wins.
+ */
+//**************************************************************************************************
+void PlotManager::SetNumLoaderThreads(uint32_t nThreads)
+{
+  mNumLoaderThreads = (nThreads > 0) ? nThreads : 1;
+}
+
+//**************************************************************************************************
+/**
+ * Enable the persistent data cache in the specified directory. Data extracted from the input files
+ * are stored there and re-used in subsequent runs as long as the input files do not change.
+ * An empty path disables the cache.
+ */
+//**************************************************************************************************
+void PlotManager::SetCacheDirectory(const string& path)
+{
+  mCacheDirectory = path;
+  mDataCache.reset();
+}
+
+//**************************************************************************************************
+/**
+ * Set maximum size (in MB) of the persistent data cache. Least recently used entries are evicted first.
+ */
+//**************************************************************************************************
+void PlotManager::SetCacheSizeLimit(uint64_t sizeMB)
+{
+  mCacheSizeLimit = sizeMB;
+  mDataCache.reset();
+}
+
+//**************************************************************************************************
+/**
+ * Use a catalog of the content of the input files to directly access the required data.
+ * When the input files are loaded from a config file, the catalog is persisted next to it.
+ */
+//**************************************************************************************************
+void PlotManager::SetUseDataCatalog(bool useDataCatalog)
+{
+  mUseDataCatalog = useDataCatalog;
+  if (!mUseDataCatalog) mDataCatalog.reset();
+}
+
+//**************************************************************************************************
+/**
+ * Load the input data only when they are needed by the plot that is currently generated instead of
+ * loading the data for all requested plots upfront. Data needed by one plot are still read in one go.
+ */
+//**************************************************************************************************
+void PlotManager::SetUseLazyLoading(bool useLazyLoading)
+{
+  mUseLazyLoading = useLazyLoading;
+}
+
+//**************************************************************************************************
+/**
+ * Limit the memory (in MB) occupied by the input data. Plots are then generated in an order that keeps
+ * plots sharing input data together, data are loaded only when needed and released again
+ * as soon as no remaining plot requires them. A budget of 0 means no limit: data are kept until ClearDataBuffer is called.
+ */
+//**************************************************************************************************
+void PlotManager::SetMemoryBudget(uint64_t sizeMB)
+{
+  mMemoryBudget = sizeMB;
+}
+
+//**************************************************************************************************
+/**
+ * Number of upcoming plots whose data are read in the background while the current plot is generated.
+ * The prefetched data are bounded by the memory budget (if set). A depth of 0 disables prefetching.
+ */
+//**************************************************************************************************
+void PlotManager::SetPrefetchDepth(uint32_t nPlots)
+{
+  mPrefetchDepth = nPlots;
+}
+
+//**************************************************************************************************
+/**
+ * Number of processes that create and save the plots in parallel. The worker processes are forked
+ * once all input data are in the buffer, so this requires that the data are not loaded on demand
+ * (lazy loading, memory budget or prefetching). Interactive mode always uses a single process.
+ */
+//**************************************************************************************************
+void PlotManager::SetNumRenderProcesses(uint32_t nProcesses)
+{
+  mNumRenderProcesses = (nProcesses > 0) ? nProcesses : 1;
+}
+
+//**************************************************************************************************
+/**
+ * Define format of the csv files belonging to an input identifier. Without identifier, the default format is set.
+ */
+//**************************************************************************************************
+void PlotManager::SetCSVFormat(const csv_format_t& format, const string& inputIdentifier)
+{
+  mCSVFormats[inputIdentifier] = format;
 }
 
 //**************************************************************************************************
@@ -216,6 +382,7 @@ void PlotManager::AddPlot(Plot& plot)
                                 return removePlot;
                               }),
                mPlots.end());
+  mRenderPlans.erase(plot.GetUniqueName());
   mPlots.push_back(std::move(plot));
 }
 
@@ -234,6 +401,10 @@ void PlotManager::AddPlotTemplate(Plot& plotTemplate)
                                         return removePlot;
                                       }),
                        mPlotTemplates.end());
+  for (auto planIt = mRenderPlans.begin(); planIt != mRenderPlans.end();) {
+    const auto& plotTemplateName = planIt->second->GetPlot().GetPlotTemplateName();
+    planIt = (plotTemplateName && *plotTemplateName == plotTemplate.GetName()) ? mRenderPlans.erase(planIt) : std::next(planIt);
+  }
   mPlotTemplates.push_back(std::move(plotTemplate));
 }
 
@@ -311,8 +482,10 @@ ptree& PlotManager::ReadPlotTemplatesFromFile(const string& plotFileName)
 bool PlotManager::GeneratePlot(Plot& plot, const string& outputMode)
 {
   // if plot already exists, delete the old one first
+  shared_ptr<TCanvas> previousCanvas;
   if (mPlotLedger.find(plot.GetUniqueName()) != mPlotLedger.end()) {
-    ERROR(R"(Plot "{}" was already created. Replacing it.)", plot.GetUniqueName());
+    if (!mIsWatching) ERROR(R"(Plot "{}" was already created. Replacing it.)", plot.GetUniqueName());
+    previousCanvas = mPlotLedger[plot.GetUniqueName()];
     mPlotLedger.erase(plot.GetUniqueName());
   }
   if (plot.GetFigureGroup() == "") {
@@ -322,26 +495,34 @@ bool PlotManager::GeneratePlot(Plot& plot, const string& outputMode)
   if (outputMode == "file") {
     mSaveToRootFile = true;
   }
-  Plot fullPlot = plot;
-  if (plot.GetPlotTemplateName()) {
-    const string& plotTemplateName = *plot.GetPlotTemplateName();
-    auto iterator = std::find_if(
-      mPlotTemplates.begin(), mPlotTemplates.end(),
-      [&](Plot& plotTemplate) { return plotTemplate.GetName() == plotTemplateName; });
-    if (iterator != mPlotTemplates.end()) {
-      fullPlot = *iterator + plot;
-    } else {
-      WARNING(R"(Could not find plot template named "{}".)", plotTemplateName);
-    }
-  }
-  PlotPainter painter;
-  shared_ptr<TCanvas> canvas = painter.GeneratePlot(fullPlot, mDataBuffer);
+  shared_ptr<const RenderPlan> plan = GetRenderPlan(plot);
+  const Plot& fullPlot = plan->GetPlot();
+  if (LoadsOnDemand()) RegisterRequiredData(fullPlot);
+  if (outputMode == "interactive") InitializeGUI();
+  PlotPainter painter(&mProjectionCache, &mInterpolationCache);
+  // plots that are saved right away can draw the buffered input data directly (the painter restores them afterwards)
+  bool allowSharedData = (outputMode != "interactive" && outputMode != "file");
+  shared_ptr<TCanvas> canvas = painter.GeneratePlot(*plan, [this](const string& inputID, const string& dataName) { return GetData(inputID, dataName); }, allowSharedData);
   if (!canvas) return false;
   LOG("Created \033[1;32m{}\033[0m from group \033[1;33m{}\033[0m", fullPlot.GetName(), fullPlot.GetFigureGroup() + ((fullPlot.GetFigureCategory() != "") ? ":" + fullPlot.GetFigureCategory() : ""));
 
   // if interactive mode is specified, open window instead of saving the plot
   if (outputMode == "interactive") {
 
+    // in watch mode all plots stay open and the window of a re-created plot is updated in place
+    if (mIsWatching) {
+      if (previousCanvas) {
+        previousCanvas->cd();
+        previousCanvas->Clear();
+        canvas->DrawClonePad();
+        previousCanvas->Modified();
+        previousCanvas->Update();
+        canvas = previousCanvas;
+      }
+      mPlotLedger[plot.GetUniqueName()] = canvas;
+      return true;
+    }
+
     mPlotLedger[plot.GetUniqueName()] = canvas;
     mPlotViewHistory.push_back(&plot.GetUniqueName());
     uint32_t currPlotIndex{static_cast<uint32_t>(mPlotViewHistory.size() - 1)};
@@ -355,12 +536,23 @@ bool PlotManager::GeneratePlot(Plot& plot, const string& outputMode)
       curYpos = mPlotLedger[*mPlotViewHistory[currPlotIndex - 1]]->GetWindowTopY();
       canvas->SetWindowPosition(curXpos, curYpos - windowOffsetY);
     }
+    // windows of the default canvas implementation are hidden via the interpreter such that the Gui library
+    // is only loaded in interactive mode (other implementations can only minimize their windows)
+    auto setWindowVisible = [](TCanvas* canvas, bool isVisible) {
+      TCanvasImp* window = canvas->GetCanvasImp();
+      if (window->IsA()->InheritsFrom("TRootCanvas")) {
+        gROOT->ProcessLine(fmt::format("((TRootCanvas*){})->{}();", dynamic_cast<void*>(window), (isVisible) ? "MapRaised" : "UnmapWindow").data());
+      } else if (isVisible) {
+        window->Show();
+      } else {
+        window->Iconify();
+      }
+    };
     while (!gSystem->ProcessEvents() && gROOT->GetSelectedPad()) {
       if (canvas->GetEvent() == kButton1Double) {
         curXpos = canvas->GetWindowTopX();
         curYpos = canvas->GetWindowTopY();
-        TRootCanvas* canvasWindow = ((TRootCanvas*)canvas->GetCanvasImp());
-        canvasWindow->UnmapWindow();
+        setWindowVisible(canvas.get(), false);
         bool forward{((double_t)canvas->GetEventX() / (double_t)canvas->GetWw() > 0.5)};
         if (forward) {
           if (currPlotIndex == mPlotViewHistory.size() - 1) break;
@@ -370,13 +562,33 @@ bool PlotManager::GeneratePlot(Plot& plot, const string& outputMode)
         }
         canvas = mPlotLedger[*mPlotViewHistory[currPlotIndex]];
         canvas->SetWindowPosition(curXpos, curYpos - windowOffsetY);
-        ((TRootCanvas*)canvas->GetCanvasImp())->MapRaised();
+        setWindowVisible(canvas.get(), true);
       }
       gSystem->Sleep(20);
     }
     return true;
   }
 
+  if (outputMode == "file") {
+    mPlotLedger[plot.GetUniqueName()] = canvas;
+    return true;
+  }
+
+  // create output folders and files
+  string outputFileName = GetOutputFileName(plot, outputMode);
+  string folderName = std::filesystem::path(outputFileName).parent_path().string();
+  gSystem->Exec((string("mkdir -p ") + folderName).data());
+  canvas->SaveAs(outputFileName.data());
+  return true;
+}
+
+//**************************************************************************************************
+/**
+ * Path of the file the plot is saved to in the specified output mode.
+ */
+//**************************************************************************************************
+string PlotManager::GetOutputFileName(const Plot& plot, const string& outputMode)
+{
   const string& subFolder = plot.GetFigureCategory();
   string fileEnding = ".pdf";
   if (outputMode == "macro") {
@@ -388,22 +600,39 @@ bool PlotManager::GeneratePlot(Plot& plot, const string& outputMode)
   }
 
   string fileName = plot.GetUniqueName();
-
-  if (outputMode == "file") {
-    mPlotLedger[plot.GetUniqueName()] = canvas;
-    return true;
-  }
-
   if (!mUseUniquePlotNames) fileName = plot.GetName();
   std::replace(fileName.begin(), fileName.end(), '/', '_');
   std::replace(fileName.begin(), fileName.end(), ':', '_');
 
-  // create output folders and files
   string folderName = mOutputDirectory + "/" + plot.GetFigureGroup();
   if (subFolder != "") folderName += "/" + subFolder;
-  gSystem->Exec((string("mkdir -p ") + folderName).data());
-  canvas->SaveAs((folderName + "/" + fileName + fileEnding).data());
-  return true;
+  return folderName + "/" + fileName + fileEnding;
+}
+
+//**************************************************************************************************
+/**
+ * Hash of the state of all input files the plot might read its data from.
+ */
+//**************************************************************************************************
+size_t PlotManager::GetInputHash(const Plot& plot)
+{
+  set<string> inputIDs;
+  for (auto& [inputID, dataName] : GetRequiredData(plot)) {
+    inputIDs.insert(inputID);
+  }
+  string inputState;
+  for (auto& inputID : inputIDs) {
+    inputState += inputID + "\n";
+    auto inputFilesIt = mInputFiles.find(inputID);
+    if (inputFilesIt == mInputFiles.end()) continue;
+    for (auto& inputFileName : inputFilesIt->second) {
+      int64_t modificationTime{};
+      uint64_t fileSize{};
+      if (!get_file_status(inputFileName, modificationTime, fileSize)) modificationTime = -1;
+      inputState += fmt::format("{} {} {}\n", inputFileName, modificationTime, fileSize);
+    }
+  }
+  return std::hash<string>{}(inputState);
 }
 
 //**************************************************************************************************
@@ -419,7 +648,24 @@ void PlotManager::CreatePlots(const string& figureGroup, const string& figureCat
   bool saveSpecificPlots = !saveAll && !plotNames.empty();
   vector<Plot*> selectedPlots;
 
+  // plots saved to individual files are skipped if neither their definition nor their inputs changed
+  bool isIncremental = mUseBuildManifest && outputMode != "interactive" && outputMode != "file";
+  if (isIncremental && !mBuildManifest) mBuildManifest.reset(new BuildManifest(GetBuildManifestFileName()));
+  struct build_state_t {
+    size_t definitionHash{};
+    size_t inputHash{};
+    string outputFileName;
+    optional<std::pair<int64_t, uint64_t>> previousOutput; // modification time, size
+  };
+  map<Plot*, build_state_t> buildStates;
+  uint32_t nUpToDatePlots{};
+
+  // graphics are only initialized once plots are shown interactively (the batch state of the process is restored in the end)
+  bool wasBatch = gROOT->IsBatch();
+  if (outputMode != "interactive") gROOT->SetBatch(kTRUE);
+
   // first determine which data needs to be loaded
+  mProjectionRequests.clear();
   for (auto& plot : mPlots) {
     if (!saveAll && !(plot.GetFigureGroup() == figureGroup && plot.GetFigureCategory() == figureCategory))
       continue;
@@ -428,18 +674,22 @@ void PlotManager::CreatePlots(const string& figureGroup, const string& figureCat
     if (!plotNames.empty()) {
       plotNames.erase(std::remove(plotNames.begin(), plotNames.end(), plot.GetName()), plotNames.end());
     }
-    selectedPlots.push_back(&plot);
-
-    // determine which input data are needed for plots
-    for (auto& [padID, pad] : plot.GetPads()) {
-      for (auto& data : pad.GetData()) {
-        mDataBuffer[data->GetInputID()][data->GetName()];
-        if (data->GetType() == "ratio") {
-          const auto& ratio = std::dynamic_pointer_cast<Plot::Pad::Ratio>(data);
-          mDataBuffer[ratio->GetDenomIdentifier()][ratio->GetDenomName()];
-        }
+    if (isIncremental) {
+      build_state_t buildState{GetRenderPlan(plot)->GetHash(), GetInputHash(GetRenderPlan(plot)->GetPlot()), GetOutputFileName(plot, outputMode)};
+      if (!mForceRebuild && mBuildManifest->IsUpToDate(plot.GetUniqueName(), buildState.definitionHash, buildState.inputHash, buildState.outputFileName)) {
+        ++nUpToDatePlots;
+        continue;
       }
+      int64_t modificationTime{};
+      uint64_t fileSize{};
+      if (get_file_status(buildState.outputFileName, modificationTime, fileSize)) buildState.previousOutput = {modificationTime, fileSize};
+      mBuildManifest->Remove(plot.GetUniqueName()); // in case creating the plot fails
+      buildStates[&plot] = buildState;
     }
+    selectedPlots.push_back(&plot);
+    RegisterProjections(GetRenderPlan(plot)->GetPlot());
+    // in lazy mode the data are only registered right before the plot is generated
+    if (!LoadsOnDemand()) RegisterRequiredData(plot);
   }
 
   // were definitions for all requeseted plots available?
@@ -449,172 +699,1313 @@ void PlotManager::CreatePlots(const string& figureGroup, const string& figureCat
               figureGroup + ((figureCategory != "") ? ":" + figureCategory : ""));
     }
   }
+  if (nUpToDatePlots > 0u) {
+    INFO("Skipping {} plot{} that {} up to date (use --force to re-create {}).", nUpToDatePlots, (nUpToDatePlots == 1) ? "" : "s", (nUpToDatePlots == 1) ? "is" : "are", (nUpToDatePlots == 1) ? "it" : "them");
+  }
+
+  // data that are already in the buffer are projected right away
+  for (auto& [dataKey, projInfos] : mProjectionRequests) {
+    auto bufferIt = mDataBuffer.find(dataKey.first);
+    if (bufferIt == mDataBuffer.end()) continue;
+    auto dataIt = bufferIt->second.find(dataKey.second);
+    if (dataIt != bufferIt->second.end()) ProjectData(dataKey, dataIt->second.get());
+  }
+  if (!LoadsOnDemand() && !FillBuffer()) PrintBufferStatus(true);
+
+  // with a memory budget, data are freed as soon as no remaining plot needs them
+  map<data_key_t, vector<uint32_t>> consumers; // data, indices of plots needing it (in reverse order)
+  if (mMemoryBudget > 0u) {
+    SortByRequiredData(selectedPlots);
+    for (uint32_t plotIndex = selectedPlots.size(); plotIndex-- > 0u;) {
+      for (auto& dataKey : GetRequiredData(*selectedPlots[plotIndex])) {
+        auto& dataConsumers = consumers[dataKey];
+        if (dataConsumers.empty() || dataConsumers.back() != plotIndex) dataConsumers.push_back(plotIndex);
+      }
+    }
+  }
+
+  bool isGenerated = false;
+  if (mPrefetchDepth > 0u) {
+    GeneratePlotsWithPrefetch(selectedPlots, consumers, outputMode);
+    isGenerated = true;
+  } else if (mNumRenderProcesses > 1u && selectedPlots.size() > 1u && outputMode != "interactive") {
+    if (LoadsOnDemand()) {
+      WARNING("Plots are created in a single process since the input data are loaded on demand.");
+    } else {
+      GeneratePlotsInWorkers(selectedPlots, outputMode);
+      isGenerated = true;
+    }
+  }
 
-  if (!FillBuffer()) PrintBufferStatus(true);
   // generate plots
-  for (auto plot : selectedPlots) {
+  for (uint32_t plotIndex = 0u; plotIndex < selectedPlots.size() && !isGenerated; ++plotIndex) {
+    Plot* plot = selectedPlots[plotIndex];
     if (!GeneratePlot(*plot, outputMode))
       ERROR(R"(Plot "{}" in figure group "{}" could not be created.)", plot->GetName(), plot->GetFigureGroup());
+    if (mMemoryBudget > 0u) ReleaseData(plotIndex, consumers);
   }
+  // the data cache is written once all data of this run were loaded
+  mDataCache.reset();
+
+  // plots count as created once their output file was (re-)written
+  if (isIncremental) {
+    for (auto& [plot, buildState] : buildStates) {
+      int64_t modificationTime{};
+      uint64_t fileSize{};
+      if (!get_file_status(buildState.outputFileName, modificationTime, fileSize)) continue;
+      if (buildState.previousOutput && *buildState.previousOutput == std::make_pair(modificationTime, fileSize)) continue;
+      mBuildManifest->Update(plot->GetUniqueName(), buildState.definitionHash, buildState.inputHash, buildState.outputFileName);
+    }
+    mBuildManifest->Save();
+  }
+  if (outputMode != "interactive") gROOT->SetBatch(wasBatch);
 }
 
 //**************************************************************************************************
 /**
- * Fills all the nodes defined in buffer hash map with data read from files.
+ * The build manifest is stored next to the output directory.
  */
 //**************************************************************************************************
-bool PlotManager::FillBuffer()
+string PlotManager::GetBuildManifestFileName()
 {
-  bool success = true;
-  for (auto& [inputID, buffer] : mDataBuffer) {
-    unordered_map<string, vector<string>> requiredData; // subdir, names
-    for (auto& [dataName, dataPtr] : buffer) {
-      if (dataPtr) continue;
-      auto pathPos = dataName.find_last_of("/");
-      string path;
-      string name = dataName;
-      if (pathPos != string::npos) {
-        path = name.substr(0, pathPos);
-        name.erase(0, pathPos + 1);
-      }
-      requiredData[std::move(path)].push_back(std::move(name));
-    }
-
-    // open all input files belonging to the current inputID and extract the data
-    for (auto& inputFileName : mInputFiles[inputID]) {
-      if (requiredData.empty()) break;
-      if (inputFileName.rfind(".csv") != string::npos) {
-        string graphName = inputFileName.substr(inputFileName.rfind('/') + 1, inputFileName.rfind(".csv") - inputFileName.rfind('/') - 1);
-        ReadDataCSV(inputFileName, graphName, inputID);
-        vector<string>& names = requiredData[""];
-        names.erase(std::remove_if(names.begin(), names.end(), [&](auto& name) { return name == graphName; }), names.end());
-        if (names.empty()) requiredData.erase("");
-      }
-      if (inputFileName.rfind(".root") == string::npos) continue;
-      // check if only a sub-folder in input file should be searched
-      auto fileNamePath = split_string(inputFileName, ':');
-      string& fileName = fileNamePath[0];
-
-      TFile inputFile(fileName.data(), "READ");
-      if (inputFile.IsZombie()) {
-        ERROR(R"(Input file "{}" not found.)", fileName);
-        break;
-      }
+  std::filesystem::path outputDirectory = std::filesystem::path(expand_path(mOutputDirectory)).lexically_normal();
+  if (!outputDirectory.has_filename()) outputDirectory = outputDirectory.parent_path();
+  return outputDirectory.string() + ".manifest.XML";
+}
 
-      TObject* folder = &inputFile;
+//**************************************************************************************************
+/**
+ * Generates plots in worker processes that are forked once all data are in the buffer.
+ * Each worker creates and saves every n-th plot. The log output of the workers is collected
+ * and printed in the order of the plots. If not all workers could be started, the plots of the missing
+ * workers are created by the main process afterwards and their output follows the one of the workers. In file mode the workers store their canvases in
+ * temporary files in the output directory that are combined into the single output file by the main process.
+ */
+//**************************************************************************************************
+void PlotManager::GeneratePlotsInWorkers(vector<Plot*>& plots, const string& outputMode)
+{
+  uint32_t nWorkers = std::min<uint32_t>(mNumRenderProcesses, plots.size());
+  bool isFileMode = (outputMode == "file");
+  std::filesystem::path workerDirectory = (mOutputDirectory.empty()) ? "." : expand_path(mOutputDirectory);
+  if (isFileMode) {
+    std::error_code errorCode;
+    std::filesystem::create_directories(workerDirectory, errorCode);
+  }
+  auto getWorkerFileName = [&workerDirectory, mainPID = getpid()](uint32_t worker) {
+    return (workerDirectory / fmt::format(".worker_{}_{}.root", mainPID, worker)).string();
+  };
+  const char endOfPlot = '\x1e'; // followed by status and index of the plot
 
-      // find top level entry point for this input file
-      if (fileNamePath.size() > 1) {
-        auto filePath = split_string(fileNamePath[1], '/');
-        // append subspecification from input name
-        folder = FindSubDirectory(folder, filePath);
-        if (!folder) {
-          ERROR(R"(Subdirectory "{}" not found in file "{}".)", fileNamePath[1], fileName);
-          return false;
-        }
+  fflush(stdout);
+  fflush(stderr);
+  vector<pid_t> workers;
+  vector<pollfd> pipes; // read end of the pipe receiving the output of each worker
+  for (uint32_t worker = 0u; worker < nWorkers; ++worker) {
+    int pipeDescriptors[2];
+    if (pipe(pipeDescriptors) != 0) {
+      ERROR("Could not create pipe for worker process.");
+      break;
+    }
+    pid_t pid = fork();
+    if (pid < 0) {
+      ERROR("Could not create worker process.");
+      close(pipeDescriptors[0]);
+      close(pipeDescriptors[1]);
+      break;
+    }
+    if (pid == 0) {
+      // worker process: it leaves without any cleanup since all its resources belong to the main process
+      for (auto& readEnd : pipes) {
+        close(readEnd.fd);
       }
-
-      vector<string> emptySubDirs;
-      for (auto& [pathStr, names] : requiredData) {
-        auto path = split_string(pathStr, '/');
-        TObject* subfolder = FindSubDirectory(folder, path);
-        if (subfolder) {
-          // recursively traverse the file and look for input files
-          string prefix = (pathStr.empty()) ? "" : pathStr + "/";
-          string suffix = gNameGroupSeparator + inputID;
-          ReadData(subfolder, names, prefix, suffix, inputID);
-          // in case a subdrectory was opened, properly delete it
-          if (!path.empty() && subfolder != &inputFile) {
-            delete subfolder;
-            subfolder = nullptr;
+      close(pipeDescriptors[0]);
+      dup2(pipeDescriptors[1], STDOUT_FILENO);
+      dup2(pipeDescriptors[1], STDERR_FILENO);
+      setvbuf(stdout, nullptr, _IOLBF, 0);
+      for (uint32_t plotIndex = worker; plotIndex < plots.size(); plotIndex += nWorkers) {
+        Plot* plot = plots[plotIndex];
+        bool success = GeneratePlot(*plot, outputMode);
+        if (!success)
+          ERROR(R"(Plot "{}" in figure group "{}" could not be created.)", plot->GetName(), plot->GetFigureGroup());
+        fflush(stdout);
+        fflush(stderr);
+        string status = fmt::format("{}{}{}\n", endOfPlot, (success) ? 1 : 0, plotIndex);
+        if (write(STDOUT_FILENO, status.data(), status.size()) < 0) _exit(1);
+      }
+      int exitCode = 0;
+      if (isFileMode) {
+        TFile workerFile(getWorkerFileName(worker).data(), "RECREATE");
+        if (workerFile.IsZombie()) {
+          exitCode = 1;
+          std::error_code errorCode;
+          std::filesystem::remove(getWorkerFileName(worker), errorCode);
+        } else {
+          for (uint32_t plotIndex = worker; plotIndex < plots.size(); plotIndex += nWorkers) {
+            auto canvasIt = mPlotLedger.find(plots[plotIndex]->GetUniqueName());
+            if (canvasIt != mPlotLedger.end()) canvasIt->second->Write(std::to_string(plotIndex).data());
           }
+          workerFile.Close();
         }
-        if (names.empty()) emptySubDirs.push_back(pathStr);
       }
-      // finally also remove top level folder
-      if (folder != &inputFile) {
-        delete folder;
-        folder = nullptr;
+      fflush(stdout);
+      fflush(stderr);
+      _exit(exitCode);
+    }
+    close(pipeDescriptors[1]);
+    workers.push_back(pid);
+    pipes.push_back({pipeDescriptors[0], POLLIN, 0});
+  }
+
+  // plots of workers that could not be started are created by the main process afterwards
+  // (they are skipped when printing the output of the workers in plot order and counted once they were created)
+  map<uint32_t, std::pair<string, bool>> finishedPlots; // plot index, output and status
+  vector<bool> isReported(plots.size(), false);
+  vector<Plot*> remainingPlots;
+  for (uint32_t plotIndex = 0u; plotIndex < plots.size(); ++plotIndex) {
+    if (plotIndex % nWorkers < workers.size()) continue;
+    finishedPlots[plotIndex] = {"", true};
+    remainingPlots.push_back(plots[plotIndex]);
+  }
+  uint32_t nextPlot = 0u;
+  uint32_t nFailedPlots = 0u;
+  auto printFinishedPlots = [&]() {
+    for (auto plotIt = finishedPlots.find(nextPlot); plotIt != finishedPlots.end(); plotIt = finishedPlots.find(++nextPlot)) {
+      fmt::print("{}", plotIt->second.first);
+      if (!plotIt->second.second) ++nFailedPlots;
+      finishedPlots.erase(plotIt);
+    }
+    fflush(stdout);
+  };
+
+  // collect the output of the workers and split it into the parts belonging to each plot
+  vector<string> outputs(workers.size());
+  uint32_t nOpenPipes = pipes.size();
+  char readBuffer[4096];
+  while (nOpenPipes > 0u) {
+    if (poll(pipes.data(), pipes.size(), -1) < 0) {
+      if (errno == EINTR) continue;
+      break;
+    }
+    for (uint32_t worker = 0u; worker < pipes.size(); ++worker) {
+      if (pipes[worker].fd < 0 || !(pipes[worker].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+      ssize_t length = read(pipes[worker].fd, readBuffer, sizeof(readBuffer));
+      if (length <= 0) {
+        close(pipes[worker].fd);
+        pipes[worker].fd = -1;
+        --nOpenPipes;
+        continue;
+      }
+      string& output = outputs[worker];
+      output.append(readBuffer, length);
+      size_t markerPos;
+      while ((markerPos = output.find(endOfPlot)) != string::npos) {
+        size_t lineEnd = output.find('\n', markerPos);
+        if (lineEnd == string::npos) break;
+        uint32_t plotIndex = std::stoul(output.substr(markerPos + 2, lineEnd - markerPos - 2));
+        if (plotIndex < plots.size()) {
+          finishedPlots[plotIndex] = {output.substr(0, markerPos), output[markerPos + 1] == '1'};
+          isReported[plotIndex] = true;
+        }
+        output.erase(0, lineEnd + 1);
       }
+    }
+    printFinishedPlots();
+  }
+
+  // plots of workers that terminated unexpectedly are reported as failed
+  vector<Plot*> lostPlots;
+  for (uint32_t worker = 0u; worker < workers.size(); ++worker) {
+    int status{};
+    waitpid(workers[worker], &status, 0);
+    bool hasFailed = !WIFEXITED(status) || WEXITSTATUS(status) != 0;
+    for (uint32_t plotIndex = worker; plotIndex < plots.size(); plotIndex += nWorkers) {
+      if (isReported[plotIndex]) continue;
+      finishedPlots[plotIndex] = {outputs[worker], false};
+      outputs[worker].clear();
+      lostPlots.push_back(plots[plotIndex]);
+    }
+    if (hasFailed) ERROR("Worker process {} terminated unexpectedly.", worker);
+  }
+  printFinishedPlots();
+  for (auto plot : lostPlots) {
+    ERROR(R"(Plot "{}" in figure group "{}" could not be created.)", plot->GetName(), plot->GetFigureGroup());
+  }
 
-      for (auto& pathStr : emptySubDirs) {
-        requiredData.erase(pathStr);
+  // collect the canvases for the combined output file
+  if (isFileMode) {
+    mSaveToRootFile = true;
+    bool addDirStatus = TH1::AddDirectoryStatus();
+    TH1::AddDirectory(false);
+    for (uint32_t worker = 0u; worker < workers.size(); ++worker) {
+      string workerFileName = getWorkerFileName(worker);
+      if (!file_exists(workerFileName)) continue;
+      TFile workerFile(workerFileName.data(), "READ");
+      for (uint32_t plotIndex = worker; plotIndex < plots.size() && !workerFile.IsZombie(); plotIndex += nWorkers) {
+        if (TCanvas* canvas = (TCanvas*)workerFile.Get(std::to_string(plotIndex).data())) {
+          mPlotLedger[plots[plotIndex]->GetUniqueName()].reset(canvas);
+        }
       }
     }
-    success &= requiredData.empty();
+    TH1::AddDirectory(addDirStatus);
   }
-  return success;
+  // the temporary files are removed no matter if they could be merged
+  for (uint32_t worker = 0u; worker < workers.size() && isFileMode; ++worker) {
+    std::error_code errorCode;
+    std::filesystem::remove(getWorkerFileName(worker), errorCode);
+  }
+
+  for (auto plot : remainingPlots) {
+    if (GeneratePlot(*plot, outputMode)) continue;
+    ERROR(R"(Plot "{}" in figure group "{}" could not be created.)", plot->GetName(), plot->GetFigureGroup());
+    ++nFailedPlots;
+  }
+  INFO("Created {} of {} plots in {} worker processes.", plots.size() - nFailedPlots, plots.size(), workers.size());
 }
 
 //**************************************************************************************************
 /**
- * Show which data could and could not be found.
+ * Creates plots and then watches the input files and the plot definition file for modifications.
+ * Only data from modified input files are re-read and only the plots depending on them
+ * (or whose definition changed) are re-created.
  */
 //**************************************************************************************************
-void PlotManager::PrintBufferStatus(bool missingOnly)
+void PlotManager::WatchPlots(const string& plotFileName, const vector<string>& figureGroupsWithCategoryUser,
+                             const vector<string>& plotNamesUser, const string& outputMode)
 {
-  INFO("===============================================");
-  if (missingOnly) {
-    INFO("================= Missing Data ================");
-  } else {
-    INFO("================= Data Buffer =================");
+  FileWatcher watcher;
+  if (!watcher.IsValid()) {
+    ExtractPlotsFromFile(plotFileName, figureGroupsWithCategoryUser, plotNamesUser, outputMode);
+    return;
   }
-  uint32_t nNeededData{};
-  uint32_t nAvailableData{};
-  for (auto& [inputID, buffer] : mDataBuffer) {
-    bool printInputID = true;
-    for (auto& [dataName, dataPtr] : buffer) {
-      ++nNeededData;
-      string colorStart = (dataPtr) ? "\033[32m" : "\033[31m";
-      string colorEnd = (dataPtr) ? "\033[0m" : "\033[0m";
-      bool show = missingOnly ? (dataPtr == nullptr) : true;
-      if (dataPtr) ++nAvailableData;
-      if (show) {
-        if (printInputID) INFO("{}", inputID);
-        printInputID = false;
-        INFO(" - {}{}{}", colorStart, dataName, colorEnd);
+  mIsWatching = true;
+
+  // physical input files and the input identifiers using them
+  map<string, set<string>> inputIDsOfFile;
+  for (auto& [inputID, inputFileNames] : mInputFiles) {
+    for (auto& inputFileName : inputFileNames) {
+      string fileName = FileWatcher::GetNormalizedPath(expand_path(split_string(inputFileName, ':')[0]));
+      inputIDsOfFile[fileName].insert(inputID);
+      watcher.AddFile(fileName);
+    }
+  }
+  string plotDefinitionFile = FileWatcher::GetNormalizedPath(expand_path(plotFileName));
+  watcher.AddFile(plotDefinitionFile);
+
+  ExtractPlotsFromFile(plotFileName, figureGroupsWithCategoryUser, plotNamesUser, "load");
+  CreatePlots("", "", {}, outputMode);
+  if (mSaveToRootFile) SavePlotsToFile();
+  map<string, ptree> definitions = GetPlotDefinitions();
+
+  bool isInteractive = (outputMode == "interactive");
+  INFO("Watching {} input files and the plot definitions for changes.", inputIDsOfFile.size());
+  while (true) {
+    if (isInteractive) gSystem->ProcessEvents();
+    set<string> changedFiles = watcher.GetChangedFiles((isInteractive) ? 20 : 1000);
+    if (changedFiles.empty()) continue;
+
+    // discard outdated data; the emptied nodes are filled again when the plots are re-created
+    set<string> changedInputIDs;
+    for (auto& fileName : changedFiles) {
+      auto inputIDsIt = inputIDsOfFile.find(fileName);
+      if (inputIDsIt == inputIDsOfFile.end()) continue;
+      INFO(R"(Input file "{}" changed.)", fileName);
+      changedInputIDs.insert(inputIDsIt->second.begin(), inputIDsIt->second.end());
+    }
+    for (auto& inputID : changedInputIDs) {
+      auto bufferIt = mDataBuffer.find(inputID);
+      if (bufferIt == mDataBuffer.end()) continue;
+      for (auto& [dataName, data] : bufferIt->second) {
+        ReleaseProjections(data.get());
+        data.reset();
+      }
+    }
+
+    // reload plot definitions and find out which of them changed
+    set<string> changedPlots;
+    if (changedFiles.find(plotDefinitionFile) != changedFiles.end()) {
+      INFO(R"(Plot definitions "{}" changed.)", plotFileName);
+      ptree plotTree;
+      bool isValidFile = true;
+      try {
+        using boost::property_tree::read_xml;
+        read_xml(plotDefinitionFile, plotTree);
+      } catch (...) {
+        ERROR(R"(Cannot load file "{}". Keeping the previous plot definitions.)", plotFileName);
+        isValidFile = false;
+      }
+      if (isValidFile) {
+        mPropertyTreeCache[plotFileName] = std::move(plotTree);
+        mPlotViewHistory.clear();
+        mPlots.clear();
+        mPlotTemplates.clear();
+        auto renderPlans = std::move(mRenderPlans);
+        mRenderPlans.clear();
+        ExtractPlotsFromFile(plotFileName, figureGroupsWithCategoryUser, plotNamesUser, "load");
+        map<string, ptree> newDefinitions = GetPlotDefinitions();
+        for (auto& [uniqueName, definition] : newDefinitions) {
+          auto definitionIt = definitions.find(uniqueName);
+          if (definitionIt == definitions.end() || definitionIt->second != definition) changedPlots.insert(uniqueName);
+          // plans of unchanged plots stay valid
+          auto planIt = renderPlans.find(uniqueName);
+          if (planIt != renderPlans.end() && planIt->second->GetHash() == RenderPlan::GetHash(definition)) mRenderPlans[uniqueName] = planIt->second;
+        }
+        for (auto& [uniqueName, definition] : definitions) {
+          if (newDefinitions.find(uniqueName) == newDefinitions.end()) mPlotLedger.erase(uniqueName);
+        }
+        definitions = std::move(newDefinitions);
+      }
+    }
+
+    vector<Plot*> affectedPlots;
+    for (auto& plot : mPlots) {
+      bool isAffected = (changedPlots.find(plot.GetUniqueName()) != changedPlots.end());
+      for (auto& [inputID, dataName] : GetRequiredData(plot)) {
+        if (isAffected) break;
+        isAffected = (changedInputIDs.find(inputID) != changedInputIDs.end());
+      }
+      if (isAffected) affectedPlots.push_back(&plot);
+    }
+    if (affectedPlots.empty()) continue;
+
+    INFO("Re-creating {} plot{}.", affectedPlots.size(), (affectedPlots.size() == 1) ? "" : "s");
+    mProjectionRequests.clear();
+    for (auto plot : affectedPlots) {
+      RegisterProjections(GetRenderPlan(*plot)->GetPlot());
+    }
+    if (!LoadsOnDemand()) {
+      for (auto plot : affectedPlots) {
+        RegisterRequiredData(*plot);
       }
+      if (!FillBuffer()) PrintBufferStatus(true);
+    }
+    bool wasBatch = gROOT->IsBatch();
+    if (outputMode != "interactive") gROOT->SetBatch(kTRUE);
+    for (auto plot : affectedPlots) {
+      if (!GeneratePlot(*plot, outputMode))
+        ERROR(R"(Plot "{}" in figure group "{}" could not be created.)", plot->GetName(), plot->GetFigureGroup());
     }
+    if (outputMode != "interactive") gROOT->SetBatch(wasBatch);
+    mDataCache.reset();
+    if (mSaveToRootFile) SavePlotsToFile();
   }
-  INFO("Found {}/{} required input data.", nAvailableData, nNeededData);
-  INFO("===============================================");
 }
 
 //**************************************************************************************************
 /**
- * Show which plots are currently loaded in the framework.
+ * Get definitions of all loaded plots (including their templates) to detect modifications.
  */
 //**************************************************************************************************
-void PlotManager::PrintLoadedPlots()
+map<string, ptree> PlotManager::GetPlotDefinitions()
 {
-  INFO("===============================================");
-  INFO("================ Loaded Plots =================");
-
-  string figureGroup;
+  map<string, ptree> definitions;
   for (auto& plot : mPlots) {
-    uint8_t nInputs{};
-    if (figureGroup != plot.GetFigureGroup()) {
-      figureGroup = plot.GetFigureGroup();
-      INFO("{}", figureGroup);
-    }
-    INFO(" - {}{}", plot.GetName(), (plot.GetFigureCategory().empty()) ? "" : " (" + plot.GetFigureCategory() + ")");
-    INFO("     ndata = {}", plot.InputDataCount());
+    definitions[plot.GetUniqueName()] = RenderPlan::GetDefinition(plot, GetPlotTemplate(plot));
   }
-  INFO("{} plots were loaded.", mPlots.size());
-  INFO("===============================================");
+  return definitions;
 }
 
 //**************************************************************************************************
 /**
- * Recursively reads data from folder / list and adds it to output data array.
- * Found dataNames are remeoved from the vectors.
+ * Find template of plot. Returns nullptr if plot has no (valid) template.
  */
 //**************************************************************************************************
-void PlotManager::ReadData(TObject* folder, vector<string>& dataNames, const string& prefix, const string& suffix, const string& inputID)
+const Plot* PlotManager::GetPlotTemplate(const Plot& plot)
 {
-  TCollection* itemList = nullptr;
-  if (folder->InheritsFrom("TDirectory")) {
-    itemList = ((TDirectoryFile*)folder)->GetListOfKeys();
+  if (!plot.GetPlotTemplateName()) return nullptr;
+  auto templateIt = std::find_if(mPlotTemplates.begin(), mPlotTemplates.end(),
+                                 [&](Plot& plotTemplate) { return plotTemplate.GetName() == *plot.GetPlotTemplateName(); });
+  if (templateIt == mPlotTemplates.end()) return nullptr;
+  return &(*templateIt);
+}
+
+//**************************************************************************************************
+/**
+ * Get compiled plan of plot (combined with its template). Plans are compiled only once and re-used
+ * until the plot or its template are replaced.
+ */
+//**************************************************************************************************
+shared_ptr<const RenderPlan> PlotManager::GetRenderPlan(const Plot& plot)
+{
+  auto planIt = mRenderPlans.find(plot.GetUniqueName());
+  if (planIt != mRenderPlans.end()) return planIt->second;
+
+  const Plot* plotTemplate = GetPlotTemplate(plot);
+  if (plot.GetPlotTemplateName() && !plotTemplate) {
+    WARNING(R"(Could not find plot template named "{}".)", *plot.GetPlotTemplateName());
+  }
+  auto plan = std::make_shared<const RenderPlan>(plot, plotTemplate);
+  mRenderPlans[plot.GetUniqueName()] = plan;
+  return plan;
+}
+
+//**************************************************************************************************
+/**
+ * Generates plots while a background thread reads the data of the next plots (producer-consumer pipeline).
+ * The background thread only works on its own data; results are moved to the data buffer by the main thread
+ * right before the plot needing them is generated.
+ */
+//**************************************************************************************************
+void PlotManager::GeneratePlotsWithPrefetch(vector<Plot*>& plots, map<data_key_t, vector<uint32_t>>& consumers, const string& outputMode)
+{
+  // data of each plot that are not yet in the buffer (data needed by several plots are loaded for the first one)
+  vector<vector<data_key_t>> dataToLoad(plots.size());
+  set<data_key_t> scheduledData;
+  for (auto& [inputID, buffer] : mDataBuffer) {
+    for (auto& [dataName, dataPtr] : buffer) {
+      if (dataPtr) scheduledData.insert({inputID, dataName});
+    }
+  }
+  for (uint32_t plotIndex = 0u; plotIndex < plots.size(); ++plotIndex) {
+    for (auto& dataKey : GetRequiredData(*plots[plotIndex])) {
+      if (scheduledData.insert(dataKey).second) dataToLoad[plotIndex].push_back(dataKey);
+    }
+  }
+
+  for (auto plot : plots) {
+    RegisterTreeHistograms(*plot);
+  }
+  if (mUseDataCatalog && !mDataCatalog) {
+    mDataCatalog.reset(new DataCatalog(mCatalogFileName));
+  }
+  ROOT::EnableThreadSafety();
+
+  std::mutex mutex;
+  std::condition_variable condition;
+  vector<data_buffer_t> loadedData(plots.size());
+  vector<uint64_t> loadedSize(plots.size(), 0u);
+  vector<bool> isLoaded(plots.size(), false);
+  uint32_t currentPlot{0u};
+  uint64_t bufferSize{0u};  // size of data in buffer
+  uint64_t pendingSize{0u}; // size of loaded data not yet moved to the buffer
+  bool stop{false};
+  const uint64_t memoryBudget = mMemoryBudget * 1024 * 1024;
+
+  std::thread loader([&]() {
+    for (uint32_t plotIndex = 0u; plotIndex < plots.size(); ++plotIndex) {
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait(lock, [&]() {
+          if (stop || plotIndex == currentPlot) return true;
+          if (plotIndex > currentPlot + mPrefetchDepth) return false;
+          return memoryBudget == 0u || bufferSize + pendingSize < memoryBudget;
+        });
+        if (stop) return;
+      }
+      data_buffer_t data = LoadData(dataToLoad[plotIndex]);
+      uint64_t size{0u};
+      for (auto& [inputID, dataOfID] : data) {
+        for (auto& [dataName, dataPtr] : dataOfID) {
+          size += EstimateSize(dataPtr.get());
+        }
+      }
+      std::lock_guard<std::mutex> lock(mutex);
+      loadedData[plotIndex] = std::move(data);
+      loadedSize[plotIndex] = size;
+      pendingSize += size;
+      isLoaded[plotIndex] = true;
+      condition.notify_all();
+    }
+  });
+
+  mIsPrefetching = true;
+  for (uint32_t plotIndex = 0u; plotIndex < plots.size(); ++plotIndex) {
+    data_buffer_t data;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      currentPlot = plotIndex;
+      condition.notify_all();
+      condition.wait(lock, [&]() { return isLoaded[plotIndex]; });
+      data = std::move(loadedData[plotIndex]);
+      pendingSize -= loadedSize[plotIndex];
+    }
+    for (auto& [inputID, dataOfID] : data) {
+      auto& buffer = mDataBuffer[inputID];
+      for (auto& [dataName, dataPtr] : dataOfID) {
+        buffer[dataName] = std::move(dataPtr);
+        ProjectData({inputID, dataName}, buffer[dataName].get());
+      }
+    }
+    // data that could not be found are not added to the buffer and need to be reported here
+    if (std::any_of(dataToLoad[plotIndex].begin(), dataToLoad[plotIndex].end(), [this](auto& dataKey) { return !GetData(dataKey.first, dataKey.second, false); })) {
+      PrintBufferStatus(true, &dataToLoad[plotIndex]);
+    }
+
+    Plot* plot = plots[plotIndex];
+    if (!GeneratePlot(*plot, outputMode))
+      ERROR(R"(Plot "{}" in figure group "{}" could not be created.)", plot->GetName(), plot->GetFigureGroup());
+    if (mMemoryBudget > 0u) {
+      // data that are needed again must stay in the buffer since they will not be prefetched a second time
+      uint64_t size = ReleaseData(plotIndex, consumers, false);
+      std::lock_guard<std::mutex> lock(mutex);
+      bufferSize = size;
+      condition.notify_all();
+    }
+  }
+  mIsPrefetching = false;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stop = true;
+    condition.notify_all();
+  }
+  loader.join();
+}
+
+//**************************************************************************************************
+/**
+ * Order plots such that plots sharing input data are generated one after another.
+ * Starting from the first plot, always the plot with the largest overlap with the data of the previous plot is taken next.
+ */
+//**************************************************************************************************
+void PlotManager::SortByRequiredData(vector<Plot*>& plots)
+{
+  vector<Plot*> sortedPlots;
+  sortedPlots.reserve(plots.size());
+  vector<vector<data_key_t>> requiredData;
+  requiredData.reserve(plots.size());
+  for (auto plot : plots) {
+    requiredData.push_back(GetRequiredData(*plot));
+  }
+  vector<bool> isSorted(plots.size(), false);
+  set<data_key_t> previousData;
+  for (size_t i = 0; i < plots.size(); ++i) {
+    size_t nextIndex = plots.size();
+    size_t maxOverlap = 0u;
+    for (size_t j = 0; j < plots.size(); ++j) {
+      if (isSorted[j]) continue;
+      size_t overlap = std::count_if(requiredData[j].begin(), requiredData[j].end(), [&](auto& dataKey) { return previousData.find(dataKey) != previousData.end(); });
+      if (nextIndex == plots.size() || overlap > maxOverlap) {
+        nextIndex = j;
+        maxOverlap = overlap;
+      }
+    }
+    isSorted[nextIndex] = true;
+    sortedPlots.push_back(plots[nextIndex]);
+    previousData = {requiredData[nextIndex].begin(), requiredData[nextIndex].end()};
+  }
+  plots = std::move(sortedPlots);
+}
+
+//**************************************************************************************************
+/**
+ * Remember the projections that are needed by the plot such that all projections of the same data
+ * can be created together once the data are loaded.
+ */
+//**************************************************************************************************
+void PlotManager::RegisterProjections(const Plot& plot)
+{
+  for (auto& [padID, pad] : plot.GetPads()) {
+    for (auto& data : pad.GetData()) {
+      if (const auto& projInfo = data->GetProjInfo()) {
+        mProjectionRequests[{data->GetInputID(), data->GetName()}].push_back(*projInfo);
+      }
+      if (const auto& operation = std::dynamic_pointer_cast<Plot::Pad::Operation>(data)) {
+        if (const auto& projInfo = operation->GetProjInfoOperand()) {
+          mProjectionRequests[{operation->GetOperandIdentifier(), operation->GetOperandName()}].push_back(*projInfo);
+        }
+      }
+    }
+  }
+}
+
+//**************************************************************************************************
+/**
+ * Create all requested projections of data that are not yet cached in a single pass over the data.
+ */
+//**************************************************************************************************
+void PlotManager::ProjectData(const data_key_t& dataKey, TObject* data)
+{
+  auto requestsIt = mProjectionRequests.find(dataKey);
+  if (!data || requestsIt == mProjectionRequests.end()) return;
+  vector<const Plot::Pad::Data::proj_info_t*> projInfos;
+  vector<projection_key_t> keys;
+  set<projection_key_t> requestedKeys;
+  for (auto& projInfo : requestsIt->second) {
+    projection_key_t key{data, projInfo.dims, projInfo.ranges, projInfo.isUserCoord};
+    if (mProjectionCache.find(key) != mProjectionCache.end() || !requestedKeys.insert(key).second) continue;
+    projInfos.push_back(&projInfo);
+    keys.push_back(key);
+  }
+  // a single projection is done by the painter once it is needed
+  if (projInfos.size() < 2u) return;
+
+  vector<TH1*> projections = HistProjector::Project(data, projInfos, mNumLoaderThreads);
+  for (uint32_t i = 0; i < projections.size(); ++i) {
+    if (projections[i]) mProjectionCache[keys[i]].reset(projections[i]);
+  }
+}
+
+//**************************************************************************************************
+/**
+ * Remove all cached projections and interpolations of data before the data are removed from the buffer.
+ */
+//**************************************************************************************************
+void PlotManager::ReleaseProjections(TObject* data)
+{
+  if (!data) return;
+  mInterpolationCache.erase(data);
+  auto projectionIt = mProjectionCache.lower_bound({data, {}, {}, false});
+  while (projectionIt != mProjectionCache.end() && std::get<0>(projectionIt->first) == data) {
+    mInterpolationCache.erase(projectionIt->second.get());
+    projectionIt = mProjectionCache.erase(projectionIt);
+  }
+}
+
+//**************************************************************************************************
+/**
+ * Remove data from the buffer once they are not needed by any of the remaining plots.
+ * If the buffer still exceeds the memory budget, the data needed farthest in the future are removed as well
+ * (and re-loaded once they are needed again).
+ */
+//**************************************************************************************************
+uint64_t PlotManager::ReleaseData(uint32_t plotIndex, map<data_key_t, vector<uint32_t>>& consumers, bool evictUsedData)
+{
+  auto removeFromBuffer = [&](const data_key_t& dataKey) {
+    auto bufferIt = mDataBuffer.find(dataKey.first);
+    if (bufferIt == mDataBuffer.end()) return;
+    auto dataIt = bufferIt->second.find(dataKey.second);
+    if (dataIt == bufferIt->second.end()) return;
+    ReleaseProjections(dataIt->second.get());
+    bufferIt->second.erase(dataIt);
+    if (bufferIt->second.empty()) mDataBuffer.erase(bufferIt);
+  };
+
+  uint64_t bufferSize = 0u;
+  vector<std::pair<uint32_t, data_key_t>> nextUsages; // index of next plot needing data, data
+  for (auto consumerIt = consumers.begin(); consumerIt != consumers.end();) {
+    auto& [dataKey, dataConsumers] = *consumerIt;
+    while (!dataConsumers.empty() && dataConsumers.back() <= plotIndex) {
+      dataConsumers.pop_back();
+    }
+    if (dataConsumers.empty()) {
+      removeFromBuffer(dataKey);
+      consumerIt = consumers.erase(consumerIt);
+      continue;
+    }
+    if (TObject* data = GetData(dataKey.first, dataKey.second, false)) {
+      bufferSize += EstimateSize(data);
+      nextUsages.push_back({dataConsumers.back(), dataKey});
+    }
+    ++consumerIt;
+  }
+
+  if (!evictUsedData) return bufferSize;
+  std::sort(nextUsages.begin(), nextUsages.end(), [](auto& a, auto& b) { return a.first > b.first; });
+  for (auto& [nextUsage, dataKey] : nextUsages) {
+    if (bufferSize <= mMemoryBudget * 1024 * 1024) break;
+    bufferSize -= EstimateSize(GetData(dataKey.first, dataKey.second, false));
+    removeFromBuffer(dataKey);
+  }
+  return bufferSize;
+}
+
+//**************************************************************************************************
+/**
+ * Rough estimate of the memory occupied by data.
+ */
+//**************************************************************************************************
+uint64_t PlotManager::EstimateSize(TObject* data)
+{
+  if (!data) return 0u;
+  if (data->InheritsFrom("THnSparse")) {
+    return ((THnBase*)data)->GetNbins() * (sizeof(double_t) + ((THnBase*)data)->GetNdimensions() * sizeof(int32_t));
+  } else if (data->InheritsFrom("THnBase")) {
+    return ((THnBase*)data)->GetNbins() * sizeof(double_t);
+  } else if (data->InheritsFrom("TH1")) {
+    TH1* hist = (TH1*)data;
+    return hist->GetNcells() * sizeof(double_t) * ((hist->GetSumw2N() > 0) ? 2 : 1);
+  } else if (data->InheritsFrom("TGraph2D")) {
+    return ((TGraph2D*)data)->GetN() * sizeof(double_t) * 3;
+  } else if (data->InheritsFrom("TGraph")) {
+    uint8_t nArrays = (data->InheritsFrom("TGraphAsymmErrors")) ? 6 : (data->InheritsFrom("TGraphErrors")) ? 4 : 2;
+    return ((TGraph*)data)->GetN() * sizeof(double_t) * nArrays;
+  }
+  return sizeof(*data);
+}
+
+//**************************************************************************************************
+/**
+ * Add empty nodes to buffer hash map for all data that are needed by the plot.
+ */
+//**************************************************************************************************
+void PlotManager::RegisterRequiredData(const Plot& plot)
+{
+  if (!mIsPrefetching) RegisterTreeHistograms(plot);
+  for (auto& [inputID, dataName] : GetRequiredData(plot)) {
+    mDataBuffer[inputID][dataName];
+  }
+}
+
+//**************************************************************************************************
+/**
+ * Remember definitions of the histograms that are filled from trees. In case a definition changed,
+ * the previously filled histogram is discarded.
+ */
+//**************************************************************************************************
+void PlotManager::RegisterTreeHistograms(const Plot& plot)
+{
+  for (auto& [padID, pad] : plot.GetPads()) {
+    for (auto& data : pad.GetData()) {
+      if (data->GetType() != "tree") continue;
+      const auto& treeHistogram = std::dynamic_pointer_cast<Plot::Pad::TreeHistogram>(data);
+      tree_histogram_t definition{treeHistogram->GetName(), treeHistogram->GetTreeName(), {treeHistogram->GetExpressionX(), treeHistogram->GetNBinsX(), treeHistogram->GetMinX(), treeHistogram->GetMaxX()}};
+      if (const auto& axisY = treeHistogram->GetAxisY()) definition.y = {axisY->expression, axisY->nBins, axisY->min, axisY->max};
+      definition.cut = treeHistogram->GetCut().value_or("");
+      definition.weight = treeHistogram->GetWeight().value_or("");
+
+      data_key_t dataKey{treeHistogram->GetInputID(), treeHistogram->GetName()};
+      auto definitionIt = mTreeHistograms.find(dataKey);
+      if (definitionIt != mTreeHistograms.end() && definitionIt->second != definition) {
+        auto bufferIt = mDataBuffer.find(dataKey.first);
+        if (bufferIt != mDataBuffer.end()) {
+          auto dataIt = bufferIt->second.find(dataKey.second);
+          if (dataIt != bufferIt->second.end()) {
+            ReleaseProjections(dataIt->second.get());
+            bufferIt->second.erase(dataIt);
+          }
+        }
+      }
+      mTreeHistograms[dataKey] = definition;
+    }
+  }
+}
+
+//**************************************************************************************************
+/**
+ * Get all data (inputID, dataName) that are needed by the plot.
+ */
+//**************************************************************************************************
+vector<PlotManager::data_key_t> PlotManager::GetRequiredData(const Plot& plot)
+{
+  vector<data_key_t> requiredData;
+  for (auto& [padID, pad] : plot.GetPads()) {
+    for (auto& data : pad.GetData()) {
+      requiredData.push_back({data->GetInputID(), data->GetName()});
+      if (const auto& operation = std::dynamic_pointer_cast<Plot::Pad::Operation>(data)) {
+        requiredData.push_back({operation->GetOperandIdentifier(), operation->GetOperandName()});
+      }
+    }
+  }
+  return requiredData;
+}
+
+//**************************************************************************************************
+/**
+ * Access data in buffer hash map. In lazy mode, all data that are still missing are loaded
+ * from the input files once the first of them is requested.
+ */
+//**************************************************************************************************
+TObject* PlotManager::GetData(const string& inputID, const string& dataName, bool loadMissing)
+{
+  auto bufferIt = mDataBuffer.find(inputID);
+  if (bufferIt == mDataBuffer.end()) return nullptr;
+  auto dataIt = bufferIt->second.find(dataName);
+  if (dataIt == bufferIt->second.end()) return nullptr;
+  if (!dataIt->second && loadMissing && LoadsOnDemand() && !mIsPrefetching) {
+    if (!FillBuffer()) {
+      PrintBufferStatus(true);
+      // forget about data that are not available to avoid searching for them again within this plot
+      for (auto& [id, buffer] : mDataBuffer) {
+        for (auto it = buffer.begin(); it != buffer.end();) {
+          it = (it->second) ? std::next(it) : buffer.erase(it);
+        }
+      }
+    }
+    return GetData(inputID, dataName);
+  }
+  return dataIt->second.get();
+}
+
+//**************************************************************************************************
+/**
+ * Request for data of an input identifier from one of its input files.
+ */
+//**************************************************************************************************
+struct PlotManager::load_request_t {
+  const string* inputID;
+  const string* inputFileName; // including sub-folder specification
+  uint32_t fileIndex;          // position within the input files of the identifier
+  unordered_map<string, vector<string>> requiredData;
+  unordered_map<string, std::unique_ptr<TObject>> loadedData;
+  unordered_map<string, vector<string>> requestedData{}; // data that are actually read from the file
+  bool isValid{true};
+};
+
+//**************************************************************************************************
+/**
+ * Containers that were read from an input file. Owned containers are deleted in reverse order of their creation.
+ */
+//**************************************************************************************************
+struct PlotManager::container_cache_t {
+  TObject* topFolder{};
+  unordered_map<string, TObject*> containers; // location, container
+  vector<std::unique_ptr<TObject>> ownedContainers;
+  ~container_cache_t()
+  {
+    while (!ownedContainers.empty()) {
+      ownedContainers.pop_back();
+    }
+  }
+};
+
+//**************************************************************************************************
+/**
+ * Fills all the nodes defined in buffer hash map with data read from files.
+ */
+//**************************************************************************************************
+bool PlotManager::FillBuffer()
+{
+  // determine which data still need to be loaded
+  vector<data_key_t> missingData;
+  for (auto& [inputID, buffer] : mDataBuffer) {
+    for (auto& [dataName, dataPtr] : buffer) {
+      if (!dataPtr) missingData.push_back({inputID, dataName});
+    }
+  }
+
+  if (mUseDataCatalog && !mDataCatalog) {
+    mDataCatalog.reset(new DataCatalog(mCatalogFileName));
+  }
+  for (auto& [inputID, loadedData] : LoadData(missingData)) {
+    auto& buffer = mDataBuffer[inputID];
+    for (auto& [dataName, dataPtr] : loadedData) {
+      buffer[dataName] = std::move(dataPtr);
+      ProjectData({inputID, dataName}, buffer[dataName].get());
+    }
+  }
+
+  bool success = true;
+  for (auto& [inputID, buffer] : mDataBuffer) {
+    for (auto& [dataName, dataPtr] : buffer) {
+      success &= (dataPtr != nullptr);
+    }
+  }
+  return success;
+}
+
+//**************************************************************************************************
+/**
+ * Reads the requested data from the input files. Does not access the data buffer and can therefore
+ * run in the background while plots are generated.
+ */
+//**************************************************************************************************
+PlotManager::data_buffer_t PlotManager::LoadData(const vector<data_key_t>& dataKeys)
+{
+  // determine for each input identifier which data need to be loaded
+  unordered_map<string, unordered_map<string, vector<string>>> requiredData; // inputID, subdir, names
+  map<std::pair<string, string>, vector<const tree_histogram_t*>> requiredTreeHistograms; // (inputID, tree), histograms
+  for (auto& [inputID, dataName] : dataKeys) {
+    auto treeHistogramIt = mTreeHistograms.find({inputID, dataName});
+    if (treeHistogramIt != mTreeHistograms.end()) {
+      requiredTreeHistograms[{inputID, treeHistogramIt->second.treeName}].push_back(&treeHistogramIt->second);
+      continue;
+    }
+    auto pathPos = dataName.find_last_of("/");
+    string path;
+    string name = dataName;
+    if (pathPos != string::npos) {
+      path = name.substr(0, pathPos);
+      name.erase(0, pathPos + 1);
+    }
+    requiredData[inputID][std::move(path)].push_back(std::move(name));
+  }
+
+  // histograms based on the same tree are filled in one event loop
+  data_buffer_t loadedData;
+  for (auto& [inputTree, histograms] : requiredTreeHistograms) {
+    auto& [inputID, treeName] = inputTree;
+    auto inputFiles = mInputFiles.find(inputID);
+    if (inputFiles == mInputFiles.end()) continue;
+    vector<string> fileNames;
+    string treePath = treeName;
+    for (auto& inputFileName : inputFiles->second) {
+      if (inputFileName.rfind(".root") == string::npos) continue;
+      auto fileNamePath = split_string(inputFileName, ':');
+      if (fileNames.empty() && fileNamePath.size() > 1) treePath = fileNamePath[1] + "/" + treeName;
+      fileNames.push_back(fileNamePath[0]);
+    }
+    LOG(R"(Filling {} histogram{} from tree "{}" of input "{}".)", histograms.size(), (histograms.size() == 1) ? "" : "s", treePath, inputID);
+    vector<TH1*> filledHistograms = TreeReader::ReadHistograms(fileNames, treePath, histograms, mNumLoaderThreads);
+    for (size_t i = 0; i < histograms.size(); ++i) {
+      if (!filledHistograms[i]) continue;
+      filledHistograms[i]->SetName((histograms[i]->name + gNameGroupSeparator + inputID).data());
+      loadedData[inputID][histograms[i]->name].reset(filledHistograms[i]);
+    }
+  }
+
+  // data that were already extracted from the input files in a previous run can be taken from the cache
+  // (the cache is opened only once per run and shared with the prefetching thread)
+  DataCache* cache = nullptr;
+  if (!mCacheDirectory.empty() && !requiredData.empty()) {
+    std::lock_guard<std::mutex> lock(mDataCacheMutex);
+    if (!mDataCache) mDataCache.reset(new DataCache(mCacheDirectory, mCacheSizeLimit));
+    cache = mDataCache.get();
+  }
+
+  // every file of an input identifier is searched for all the data required from this identifier
+  vector<load_request_t> requests;
+  for (auto& [inputID, requiredDataOfID] : requiredData) {
+    auto inputFiles = mInputFiles.find(inputID);
+    if (inputFiles == mInputFiles.end()) continue;
+    for (uint32_t fileIndex = 0u; fileIndex < inputFiles->second.size(); ++fileIndex) {
+      if (requiredDataOfID.empty()) break;
+      const string& inputFileName = inputFiles->second[fileIndex];
+      auto& request = requests.emplace_back(load_request_t{&inputID, &inputFileName, fileIndex, requiredDataOfID, {}});
+      if (cache) {
+        std::lock_guard<std::mutex> lock(mDataCacheMutex);
+        request.requiredData = cache->Fetch(inputFileName, gNameGroupSeparator + inputID, requiredDataOfID, request.loadedData);
+        request.requestedData = request.requiredData;
+        EraseLoadedData(requiredDataOfID, request.loadedData);
+      }
+    }
+  }
+
+  // requests are grouped by physical file such that each file is opened only once
+  vector<std::pair<string, vector<load_request_t*>>> tasks; // file name, requests
+  unordered_map<string, size_t> taskIndices;
+  for (auto& request : requests) {
+    if (request.requiredData.empty()) continue;
+    std::error_code errorCode;
+    string fileName = split_string(*request.inputFileName, ':')[0];
+    std::filesystem::path filePath = std::filesystem::absolute(fileName, errorCode);
+    string fileKey = (errorCode) ? fileName : filePath.lexically_normal().string();
+    auto [taskIt, isNew] = taskIndices.insert({fileKey, tasks.size()});
+    if (isNew) tasks.push_back({fileName, {}});
+    tasks[taskIt->second].second.push_back(&request);
+  }
+
+  if (mNumLoaderThreads > 1 && tasks.size() > 1) {
+    ROOT::EnableThreadSafety();
+    std::atomic<size_t> nextTask{0u};
+    auto processTasks = [&]() {
+      for (size_t i = nextTask++; i < tasks.size(); i = nextTask++) {
+        ReadInputFile(tasks[i].first, tasks[i].second);
+      }
+    };
+    vector<std::thread> workers;
+    for (size_t i = 0; i < std::min<size_t>(mNumLoaderThreads, tasks.size()); ++i) {
+      workers.emplace_back(processTasks);
+    }
+    for (auto& worker : workers) {
+      worker.join();
+    }
+  } else {
+    // when reading sequentially, data found in a previous file of the same identifier need not be searched again
+    unordered_map<string, vector<load_request_t*>> finishedRequests; // inputID, requests
+    for (auto& [fileName, fileRequests] : tasks) {
+      vector<load_request_t*> openRequests;
+      for (auto request : fileRequests) {
+        for (auto finishedRequest : finishedRequests[*request->inputID]) {
+          if (finishedRequest->fileIndex > request->fileIndex) continue;
+          if (!finishedRequest->isValid) request->requiredData.clear();
+          EraseLoadedData(request->requiredData, finishedRequest->loadedData);
+        }
+        // only data that were actually searched for in this file may be stored as missing in the cache
+        request->requestedData = request->requiredData;
+        if (!request->requiredData.empty()) openRequests.push_back(request);
+      }
+      if (!openRequests.empty()) ReadInputFile(fileName, openRequests);
+      for (auto request : fileRequests) {
+        finishedRequests[*request->inputID].push_back(request);
+      }
+    }
+  }
+
+  if (cache) {
+    std::lock_guard<std::mutex> lock(mDataCacheMutex);
+    for (auto& request : requests) {
+      if (request.isValid && !request.requestedData.empty()) cache->Store(*request.inputFileName, request.requestedData, request.loadedData);
+    }
+  }
+
+  // merge the results in file order such that the first match wins
+  set<string> skippedIDs; // identifiers where an invalid file stopped the search
+  for (auto& request : requests) {
+    if (skippedIDs.find(*request.inputID) != skippedIDs.end()) continue;
+    auto& loadedDataOfID = loadedData[*request.inputID];
+    for (auto& [dataName, dataPtr] : request.loadedData) {
+      auto& loadedPtr = loadedDataOfID[dataName];
+      if (!loadedPtr) loadedPtr = std::move(dataPtr);
+    }
+    if (!request.isValid) skippedIDs.insert(*request.inputID);
+  }
+
+  if (mDataCatalog) mDataCatalog->Save();
+  return loadedData;
+}
+
+//**************************************************************************************************
+/**
+ * Removes all data from requiredData that are already contained in loadedData.
+ */
+//**************************************************************************************************
+void PlotManager::EraseLoadedData(unordered_map<string, vector<string>>& requiredData, const unordered_map<string, std::unique_ptr<TObject>>& loadedData)
+{
+  for (auto pathIt = requiredData.begin(); pathIt != requiredData.end();) {
+    auto& [path, names] = *pathIt;
+    names.erase(std::remove_if(names.begin(), names.end(), [&](auto& name) {
+                  auto dataIt = loadedData.find((path.empty()) ? name : path + "/" + name);
+                  return dataIt != loadedData.end() && dataIt->second;
+                }),
+                names.end());
+    pathIt = (names.empty()) ? requiredData.erase(pathIt) : std::next(pathIt);
+  }
+}
+
+//**************************************************************************************************
+/**
+ * Serves all requests for data from the same physical input file. The file is opened only once and its
+ * directories and lists are shared among the requests (which may point to different sub-folders).
+ * Found data are removed from requiredData and added to loadedData of each request.
+ * Requests are marked invalid in case the file cannot be used (then no further files should be searched).
+ */
+//**************************************************************************************************
+void PlotManager::ReadInputFile(const string& fileName, vector<load_request_t*>& requests)
+{
+  if (fileName.rfind(".csv") != string::npos || fileName.rfind(".tsv") != string::npos) {
+    string graphName = std::filesystem::path(fileName).stem().string();
+    for (auto request : requests) {
+      auto namesIt = request->requiredData.find("");
+      if (namesIt == request->requiredData.end()) continue;
+      vector<string>& names = namesIt->second;
+      if (std::find(names.begin(), names.end(), graphName) == names.end()) continue;
+      request->loadedData[graphName].reset(ReadDataCSV(fileName, graphName, *request->inputID));
+      names.erase(std::remove_if(names.begin(), names.end(), [&](auto& name) { return name == graphName; }), names.end());
+      if (names.empty()) request->requiredData.erase("");
+    }
+    return;
+  }
+  if (fileName.rfind(".root") == string::npos) return;
+  // files that are known not to contain any of the required data do not need to be opened
+  if (mDataCatalog && std::none_of(requests.begin(), requests.end(), [&](auto request) { return mDataCatalog->MightContain(*request->inputFileName, request->requiredData); })) return;
+
+  TFile inputFile(fileName.data(), "READ");
+  if (inputFile.IsZombie()) {
+    ERROR(R"(Input file "{}" not found.)", fileName);
+    for (auto request : requests) {
+      request->isValid = false;
+    }
+    return;
+  }
+
+  // containers (directories, lists) are read only once per file and kept until all requests are served
+  container_cache_t containers;
+  containers.topFolder = &inputFile;
+
+  for (auto request : requests) {
+    if (mDataCatalog && !mDataCatalog->MightContain(*request->inputFileName, request->requiredData)) continue;
+    // check if only a sub-folder in input file should be searched
+    auto fileNamePath = split_string(*request->inputFileName, ':');
+    string topLocation = (fileNamePath.size() > 1) ? fileNamePath[1] : "";
+    while (!topLocation.empty() && topLocation.back() == '/') topLocation.pop_back();
+    TObject* folder = GetContainer(containers, topLocation);
+    if (!folder) {
+      ERROR(R"(Subdirectory "{}" not found in file "{}".)", topLocation, fileName);
+      request->isValid = false;
+      continue;
+    }
+    string suffix = gNameGroupSeparator + *request->inputID;
+    string locationPrefix = (topLocation.empty()) ? "" : topLocation + "/";
+
+    if (mDataCatalog) {
+      if (!mDataCatalog->HasEntry(*request->inputFileName)) mDataCatalog->AddEntry(*request->inputFileName, folder);
+      ReadCatalogedData(*request->inputFileName, containers, topLocation, suffix, request->requiredData, request->loadedData);
+      continue;
+    }
+
+    vector<string> emptySubDirs;
+    for (auto& [pathStr, names] : request->requiredData) {
+      string location = (pathStr.empty()) ? topLocation : locationPrefix + pathStr;
+      TObject* subfolder = GetContainer(containers, location);
+      if (subfolder) {
+        // recursively traverse the file and look for input files
+        string prefix = (pathStr.empty()) ? "" : pathStr + "/";
+        ReadData(subfolder, location, names, prefix, suffix, request->loadedData, containers);
+      }
+      if (names.empty()) emptySubDirs.push_back(pathStr);
+    }
+
+    for (auto& pathStr : emptySubDirs) {
+      request->requiredData.erase(pathStr);
+    }
+  }
+}
+
+//**************************************************************************************************
+/**
+ * Show which data could and could not be found. Optionally, only the status of the specified data is shown.
+ */
+//**************************************************************************************************
+void PlotManager::PrintBufferStatus(bool missingOnly, const vector<data_key_t>* dataKeys)
+{
+  // data that are not in the buffer at all are shown as missing
+  map<string, map<string, bool>> isAvailable; // inputID, dataName, status
+  if (dataKeys) {
+    for (auto& [inputID, dataName] : *dataKeys) {
+      isAvailable[inputID][dataName] = (GetData(inputID, dataName, false) != nullptr);
+    }
+  } else {
+    for (auto& [inputID, buffer] : mDataBuffer) {
+      for (auto& [dataName, dataPtr] : buffer) {
+        isAvailable[inputID][dataName] = (dataPtr != nullptr);
+      }
+    }
+  }
+
+  INFO("===============================================");
+  if (missingOnly) {
+    INFO("================= Missing Data ================");
+  } else {
+    INFO("================= Data Buffer =================");
+  }
+  uint32_t nNeededData{};
+  uint32_t nAvailableData{};
+  for (auto& [inputID, statusOfID] : isAvailable) {
+    bool printInputID = true;
+    for (auto& [dataName, isFound] : statusOfID) {
+      ++nNeededData;
+      string colorStart = (isFound) ? "\033[32m" : "\033[31m";
+      string colorEnd = (isFound) ? "\033[0m" : "\033[0m";
+      bool show = missingOnly ? (!isFound) : true;
+      if (isFound) ++nAvailableData;
+      if (show) {
+        if (printInputID) INFO("{}", inputID);
+        printInputID = false;
+        INFO(" - {}{}{}", colorStart, dataName, colorEnd);
+      }
+    }
+  }
+  INFO("Found {}/{} required input data.", nAvailableData, nNeededData);
+  INFO("===============================================");
+}
+
+//**************************************************************************************************
+/**
+ * Show which plots are currently loaded in the framework.
+ */
+//**************************************************************************************************
+void PlotManager::PrintLoadedPlots()
+{
+  INFO("===============================================");
+  INFO("================ Loaded Plots =================");
+
+  string figureGroup;
+  for (auto& plot : mPlots) {
+    uint8_t nInputs{};
+    if (figureGroup != plot.GetFigureGroup()) {
+      figureGroup = plot.GetFigureGroup();
+      INFO("{}", figureGroup);
+    }
+    INFO(" - {}{}", plot.GetName(), (plot.GetFigureCategory().empty()) ? "" : " (" + plot.GetFigureCategory() + ")");
+    INFO("     ndata = {}", plot.InputDataCount());
+  }
+  INFO("{} plots were loaded.", mPlots.size());
+  INFO("===============================================");
+}
+
+//**************************************************************************************************
+/**
+ * Read data from the locations in the input file that are specified by the data catalog.
+ * Data residing in the same directory or list are read together.
+ */
+//**************************************************************************************************
+void PlotManager::ReadCatalogedData(const string& inputFileName, container_cache_t& containers, const string& topLocation, const string& suffix, unordered_map<string, vector<string>>& requiredData, unordered_map<string, std::unique_ptr<TObject>>& loadedData)
+{
+  map<string, vector<std::pair<string, string>>> dataByContainer; // container location, (name, full data name)
+  for (auto& [path, names] : requiredData) {
+    for (auto& name : names) {
+      auto location = mDataCatalog->Locate(inputFileName, path, name);
+      if (!location) continue;
+      auto pathPos = location->find_last_of('/');
+      string container = (pathPos == string::npos) ? "" : location->substr(0, pathPos);
+      dataByContainer[container].push_back({name, (path.empty()) ? name : path + "/" + name});
+    }
+  }
+
+  for (auto& [containerLocation, data] : dataByContainer) {
+    string location = (topLocation.empty() || containerLocation.empty()) ? topLocation + containerLocation : topLocation + "/" + containerLocation;
+    TObject* container = GetContainer(containers, location);
+    if (!container) continue;
+    for (auto& [name, fullName] : data) {
+      TObject* obj = nullptr;
+      if (container->InheritsFrom("TDirectory")) {
+        TKey* key = ((TDirectory*)container)->FindKey(name.data());
+        if (key) obj = key->ReadObj();
+      } else {
+        // the container stays in memory for further requests, so a copy is needed
+        TCollection* itemList = (container->InheritsFrom("TFolder")) ? ((TFolder*)container)->GetListOfFolders() : (TCollection*)container;
+        obj = itemList->FindObject(name.data());
+        if (obj) obj = obj->Clone();
+      }
+      if (!obj) continue;
+      if (obj->InheritsFrom("TDirectory") || obj->InheritsFrom("TFolder") || obj->InheritsFrom("TCollection")) {
+        delete obj;
+        continue;
+      }
+      if (obj->InheritsFrom("TH1")) ((TH1*)obj)->SetDirectory(0); // demand ownership for histogram
+      ((TNamed*)obj)->SetName((fullName + suffix).data());
+      loadedData[fullName].reset(obj);
+    }
+  }
+  EraseLoadedData(requiredData, loadedData);
+}
+
+//**************************************************************************************************
+/**
+ * Get container (directory, folder or list) at location within the input file.
+ * Each container is read only once and kept in memory until the file is closed.
+ */
+//**************************************************************************************************
+TObject* PlotManager::GetContainer(container_cache_t& containers, const string& location)
+{
+  if (location.empty()) return containers.topFolder;
+  auto containerIt = containers.containers.find(location);
+  if (containerIt != containers.containers.end()) return containerIt->second;
+
+  auto pathPos = location.find_last_of('/');
+  TObject* parent = GetContainer(containers, (pathPos == string::npos) ? "" : location.substr(0, pathPos));
+  string name = (pathPos == string::npos) ? location : location.substr(pathPos + 1);
+
+  TObject* container = nullptr;
+  if (parent) {
+    bool isOwned = false;
+    if (parent->InheritsFrom("TDirectory")) {
+      TKey* key = ((TDirectory*)parent)->FindKey(name.data());
+      if (key) {
+        container = key->ReadObj();
+        isOwned = true;
+      } else {
+        container = ((TDirectory*)parent)->FindObject(name.data());
+      }
+    } else if (parent->InheritsFrom("TFolder")) {
+      container = ((TFolder*)parent)->GetListOfFolders()->FindObject(name.data());
+    } else if (parent->InheritsFrom("TCollection")) {
+      container = ((TCollection*)parent)->FindObject(name.data());
+    }
+    if (container && !(container->InheritsFrom("TDirectory") || container->InheritsFrom("TFolder") || container->InheritsFrom("TCollection"))) {
+      if (isOwned) delete container;
+      container = nullptr;
+    }
+    if (container && isOwned) {
+      if (container->InheritsFrom("TCollection")) ((TCollection*)container)->SetOwner();
+      containers.ownedContainers.emplace_back(container);
+    }
+  }
+  containers.containers[location] = container;
+  return container;
+}
+
+//**************************************************************************************************
+/**
+ * Recursively reads data from folder / list and adds it to output data array.
+ * Found dataNames are remeoved from the vectors.
+ */
+//**************************************************************************************************
+void PlotManager::ReadData(TObject* folder, const string& location, vector<string>& dataNames, const string& prefix, const string& suffix, unordered_map<string, std::unique_ptr<TObject>>& loadedData, container_cache_t& containers)
+{
+  TCollection* itemList = nullptr;
+  if (folder->InheritsFrom("TDirectory")) {
+    itemList = ((TDirectoryFile*)folder)->GetListOfKeys();
   } else if (folder->InheritsFrom("TFolder")) {
     itemList = ((TFolder*)folder)->GetListOfFolders();
   } else if (folder->InheritsFrom("TCollection")) {
@@ -627,59 +2018,47 @@ void PlotManager::ReadData(TObject* folder, vector<string>& dataNames, const str
 
   // first match should always be the one in current level; traverse deeper only if not found
   for (bool traverse : {false, true}) {
-
-    TIter iterator = itemList->begin();
-    TObject* obj{};
-    bool deleteObject;
-    bool removeFromList;
-
-    while (iterator != itemList->end()) {
-      obj = *iterator;
-      deleteObject = true;
-      removeFromList = true;
+    for (auto item : *itemList) {
+      TObject* obj = item;
+      string itemLocation = (location.empty()) ? item->GetName() : location + "/" + item->GetName();
+      bool isKey = (item->IsA() == TKey::Class());
 
       // read actual object to memory when traversing a directory
-      if (obj->IsA() == TKey::Class()) {
-        string className = ((TKey*)obj)->GetClassName();
-        string keyName = ((TKey*)obj)->GetName();
-
+      if (isKey) {
+        string className = ((TKey*)item)->GetClassName();
         bool isTraversable = className.find("TDirectory") != string::npos || className.find("TFolder") != string::npos || className.find("TList") != string::npos || className.find("TObjArray") != string::npos;
-        if ((traverse && isTraversable) || std::find(dataNames.begin(), dataNames.end(), keyName) != dataNames.end()) {
-          obj = ((TKey*)obj)->ReadObj();
-          removeFromList = false;
+        if (isTraversable) {
+          if (!traverse) continue;
+          // sub-structures are shared with other requests for this file
+          obj = GetContainer(containers, itemLocation);
+          if (!obj) continue;
+          isKey = false;
+        } else if (std::find(dataNames.begin(), dataNames.end(), item->GetName()) != dataNames.end()) {
+          obj = ((TKey*)item)->ReadObj();
         } else {
-          ++iterator;
           continue;
         }
       }
 
       // in case this object is directory or list, repeat the same for this substructure
       if (obj->InheritsFrom("TDirectory") || obj->InheritsFrom("TFolder") || obj->InheritsFrom("TCollection")) {
-        if (traverse) ReadData(obj, dataNames, prefix, suffix, inputID);
+        if (traverse) ReadData(obj, itemLocation, dataNames, prefix, suffix, loadedData, containers);
+        if (isKey) delete obj;
       } else {
         auto it = std::find(dataNames.begin(), dataNames.end(), ((TNamed*)obj)->GetName());
         if (it != dataNames.end()) {
+          // objects within lists stay owned by the list, which may be needed again for other data
+          if (!isKey) obj = obj->Clone();
           if (obj->InheritsFrom("TH1")) ((TH1*)obj)->SetDirectory(0); // demand ownership for histogram
           // re-name data
           string fullName = prefix + ((TNamed*)obj)->GetName();
           ((TNamed*)obj)->SetName((fullName + suffix).data());
           dataNames.erase(it); // TODO: why not erase-remove?
-          mDataBuffer[inputID][fullName].reset(obj);
-          deleteObject = false;
-        }
-      }
-
-      // increase iterator before removing objects from collection
-      ++iterator;
-      if (removeFromList) {
-        if (itemList->Remove(obj) == nullptr) {
-          ERROR(R"(Could not remove item "{}" ({}) from collection "{}".)", ((TNamed*)obj)->GetName(),
-                (void*)obj, itemList->GetName());
+          loadedData[fullName].reset(obj);
+        } else if (isKey) {
+          delete obj;
         }
       }
-      if (deleteObject) {
-        delete obj;
-      }
       if (dataNames.empty()) return;
     }
   }
@@ -690,58 +2069,15 @@ void PlotManager::ReadData(TObject* folder, vector<string>& dataNames, const str
  * Read data from csv file.
  */
 //**************************************************************************************************
-void PlotManager::ReadDataCSV(const string& inputFileName, const string& graphName, const string& inputIdentifier)
+TObject* PlotManager::ReadDataCSV(const string& inputFileName, const string& graphName, const string& inputIdentifier)
 {
-  // extract from path the csv file name that will then become graph name TODO: protect this against wrong usage...
-  string delimiter = "\t"; // TODO: this must somehow be user definable
-  string pattern = "%lg %lg %lg %lg";
-  TGraphErrors* graph = new TGraphErrors(inputFileName.data(), pattern.data(), delimiter.data());
+  auto formatIt = mCSVFormats.find(inputIdentifier);
+  const csv_format_t& format = (formatIt != mCSVFormats.end()) ? formatIt->second : mCSVFormats.at("");
+  TGraph* graph = CSVReader::ReadGraph(inputFileName, format, mNumLoaderThreads);
+  if (!graph) return nullptr;
   string uniqueName = graphName + gNameGroupSeparator + inputIdentifier;
   ((TNamed*)graph)->SetName(uniqueName.data());
-  mDataBuffer[inputIdentifier][graphName].reset(graph);
-}
-
-//**************************************************************************************************
-/**
- * Recursively search for sub folder in file.
- */
-//**************************************************************************************************
-TObject* PlotManager::FindSubDirectory(TObject* folder, vector<string>& subDirs)
-{
-  if (!folder) return nullptr;
-  bool deleteFolder = true;
-  if (folder->InheritsFrom("TFile")) deleteFolder = false;
-
-  if (subDirs.empty()) {
-    if (folder->InheritsFrom("TDirectory") || folder->InheritsFrom("TFolder") || folder->InheritsFrom("TCollection")) {
-      return folder;
-    } else {
-      return nullptr;
-    }
-  }
-  TObject* subFolder{nullptr};
-  if (folder->InheritsFrom("TDirectory")) {
-    TKey* key = ((TDirectory*)folder)->FindKey(subDirs[0].data());
-    if (key) {
-      subFolder = key->ReadObj();
-    } else {
-      subFolder = ((TDirectory*)folder)->FindObject(subDirs[0].data());
-    }
-    deleteFolder = false;
-  } else if (folder->InheritsFrom("TCollection") || folder->InheritsFrom("TFolder")) {
-    subFolder = ((TCollection*)folder)->FindObject(subDirs[0].data());
-    if (subFolder) {
-      ((TCollection*)subFolder)->SetOwner();
-      // if subfolder is part of list, remove it first to avoid double deletion
-      ((TCollection*)folder)->Remove(subFolder);
-    }
-  }
-  if (deleteFolder) {
-    delete folder;
-  }
-  if (!subFolder) return nullptr;
-  subDirs.erase(subDirs.begin());
-  return FindSubDirectory(subFolder, subDirs);
+  return graph;
 }
 
 //**************************************************************************************************
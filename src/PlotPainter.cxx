@@ -19,9 +19,10 @@
 #include "PlottingFramework.h"
 #include "Logging.h"
 #include "Helpers.h"
+#include "Arithmetic.h"
 
 // std dependencies
-#include <regex>
+#include <algorithm>
 #include <numeric>
 
 // root dependencies
@@ -37,6 +38,7 @@
 #include "TProfile2D.h"
 #include "TGraph.h"
 #include "TGraphErrors.h"
+#include "TGraphAsymmErrors.h"
 #include "TGraph2D.h"
 #include "TGraph2DErrors.h"
 #include "TGraphSmooth.h"
@@ -58,19 +60,51 @@
 #include "TLatex.h"
 #include "TSpline.h"
 #include "TView.h"
-#include "TApplication.h"
-#include "TGWindow.h"
 
 namespace PlottingFramework
 {
+// process-wide cache of text dimensions in pixel: (text, font, size, pad width, pad height), (width, height)
+map<tuple<string, int16_t, float_t, uint32_t, uint32_t>, tuple<uint32_t, uint32_t>> gTextDimensionsCache;
+uint64_t gTextDimensionsCacheHits{};
+uint64_t gTextDimensionsCacheMisses{};
+
+// placeholders that can be used in lables
+const map<string, placeholder_t> gPlaceholders{
+  {"name", placeholder_t::name},
+  {"title", placeholder_t::title},
+  {"entries", placeholder_t::entries},
+  {"integral", placeholder_t::integral},
+  {"integral_visible", placeholder_t::integral_visible},
+  {"mean", placeholder_t::mean},
+  {"rms", placeholder_t::rms},
+  {"stddev", placeholder_t::stddev},
+  {"maximum", placeholder_t::maximum},
+  {"minimum", placeholder_t::minimum},
+  {"bins", placeholder_t::bins},
+  {"bins_filled", placeholder_t::bins_filled},
+};
 
 //**************************************************************************************************
 /**
- * Function to generate the plot.
+ * Destructor. Input data that were drawn directly are reset to their original state.
  */
 //**************************************************************************************************
-shared_ptr<TCanvas> PlotPainter::GeneratePlot(Plot& plot, const unordered_map<string, unordered_map<string, std::unique_ptr<TObject>>>& dataBuffer)
+PlotPainter::~PlotPainter()
 {
+  // undo in reverse order such that the oldest state is restored in the end
+  for (auto restore = mRestoreActions.rbegin(); restore != mRestoreActions.rend(); ++restore) {
+    (*restore)();
+  }
+}
+
+//**************************************************************************************************
+/**
+ * Function to generate the plot. All styles are already resolved in the render plan.
+ */
+//**************************************************************************************************
+shared_ptr<TCanvas> PlotPainter::GeneratePlot(const RenderPlan& plan, const data_getter_t& getData, bool allowSharedData)
+{
+  const Plot& plot = plan.GetPlot();
   gStyle->SetOptStat(0); // this needs to be done before creating the canvas! at later stage it would add to list of primitives in pad...
 
   if (!(plot.GetWidth() || plot.GetHeight())) {
@@ -88,10 +122,10 @@ shared_ptr<TCanvas> PlotPainter::GeneratePlot(Plot& plot, const unordered_map<st
   if (plot.GetFillStyle()) canvas_ptr->SetFillStyle(*plot.GetFillStyle());
   if (plot.IsFixAspectRatio()) canvas_ptr->SetFixedAspectRatio(*plot.IsFixAspectRatio());
 
-  auto& padDefaults = plot[0];
   for (const auto& [padID, dummy] : plot.GetPads()) {
-    if (padID == 0) continue; // pad 0 is used only to define the defaults
-    auto& pad = plot[padID];  // needed because processData lambda cannot capture variable from structured binding ('dummy')
+    if (padID == 0) continue;                      // pad 0 is used only to define the defaults
+    auto& pad = dummy;                             // needed because processData lambda cannot capture variable from structured binding ('dummy')
+    auto& padStyle = plan.GetPadStyle(padID);
 
     // Pad placing
     array<double_t, 4> padPos = {0., 0., 1., 1.};
@@ -102,29 +136,29 @@ shared_ptr<TCanvas> PlotPainter::GeneratePlot(Plot& plot, const unordered_map<st
     }
 
     // get the settings for this pad
-    auto textFont = get_first(pad.GetDefaultTextFont(), padDefaults.GetDefaultTextFont());
-    auto textSize = get_first(pad.GetDefaultTextSize(), padDefaults.GetDefaultTextSize());
-    auto textColor = get_first(pad.GetDefaultTextColor(), padDefaults.GetDefaultTextColor());
+    auto textFont = padStyle.text.style;
+    auto textSize = padStyle.text.scale;
+    auto textColor = padStyle.text.color;
 
-    string padTitle = get_first_or({""}, pad.GetTitle(), padDefaults.GetTitle());
+    const string& padTitle = padStyle.title;
 
     canvas_ptr->cd();
     string padName = "Pad_" + std::to_string(padID);
 
     TPad* pad_ptr = new TPad(padName.data(), padTitle.data(), padPos[0], padPos[1], padPos[2], padPos[3]);
 
-    if (auto marginTop = get_first(pad.GetMarginTop(), padDefaults.GetMarginTop())) pad_ptr->SetTopMargin(*marginTop);
-    if (auto marginBottom = get_first(pad.GetMarginBottom(), padDefaults.GetMarginBottom())) pad_ptr->SetBottomMargin(*marginBottom);
-    if (auto marginLeft = get_first(pad.GetMarginLeft(), padDefaults.GetMarginLeft())) pad_ptr->SetLeftMargin(*marginLeft);
-    if (auto marginRight = get_first(pad.GetMarginRight(), padDefaults.GetMarginRight())) pad_ptr->SetRightMargin(*marginRight);
-    if (auto padFillColor = get_first(pad.GetFillColor(), padDefaults.GetFillColor())) pad_ptr->SetFillColor(*padFillColor);
-    if (auto padFillStyle = get_first(pad.GetFillStyle(), padDefaults.GetFillStyle())) pad_ptr->SetFillStyle(*padFillStyle);
-    if (auto frameFillColor = get_first(pad.GetFillColorFrame(), padDefaults.GetFillColorFrame())) pad_ptr->SetFrameFillColor(*frameFillColor);
-    if (auto frameFillStyle = get_first(pad.GetFillStyleFrame(), padDefaults.GetFillStyleFrame())) pad_ptr->SetFrameFillStyle(*frameFillStyle);
-    if (auto frameLineColor = get_first(pad.GetLineColorFrame(), padDefaults.GetLineColorFrame())) pad_ptr->SetFrameLineColor(*frameLineColor);
-    if (auto frameLineStyle = get_first(pad.GetLineStyleFrame(), padDefaults.GetLineStyleFrame())) pad_ptr->SetFrameLineStyle(*frameLineStyle);
-    if (auto frameLineWidth = get_first(pad.GetLineWidthFrame(), padDefaults.GetLineWidthFrame())) pad_ptr->SetFrameLineWidth(*frameLineWidth);
-    if (auto palette = get_first(pad.GetPalette(), padDefaults.GetPalette())) gStyle->SetPalette(*palette);
+    if (padStyle.marginTop) pad_ptr->SetTopMargin(*padStyle.marginTop);
+    if (padStyle.marginBottom) pad_ptr->SetBottomMargin(*padStyle.marginBottom);
+    if (padStyle.marginLeft) pad_ptr->SetLeftMargin(*padStyle.marginLeft);
+    if (padStyle.marginRight) pad_ptr->SetRightMargin(*padStyle.marginRight);
+    if (padStyle.fillColor) pad_ptr->SetFillColor(*padStyle.fillColor);
+    if (padStyle.fillStyle) pad_ptr->SetFillStyle(*padStyle.fillStyle);
+    if (padStyle.frameFillColor) pad_ptr->SetFrameFillColor(*padStyle.frameFillColor);
+    if (padStyle.frameFillStyle) pad_ptr->SetFrameFillStyle(*padStyle.frameFillStyle);
+    if (padStyle.frameLineColor) pad_ptr->SetFrameLineColor(*padStyle.frameLineColor);
+    if (padStyle.frameLineStyle) pad_ptr->SetFrameLineStyle(*padStyle.frameLineStyle);
+    if (padStyle.frameLineWidth) pad_ptr->SetFrameLineWidth(*padStyle.frameLineWidth);
+    if (padStyle.palette) gStyle->SetPalette(*padStyle.palette);
 
     optional<vector<int16_t>> padColorGradient{};
     if (false) {        // TODO: propagate these settings from the user interface
@@ -147,123 +181,67 @@ shared_ptr<TCanvas> PlotPainter::GeneratePlot(Plot& plot, const unordered_map<st
       continue;
     }
 
-    // find data that should define the axis frame
-    auto framePos = std::find_if(pad.GetData().begin(), pad.GetData().end(),
-                                 [](auto curData) { return curData->GetDefinesFrame(); });
-    uint8_t frameDataID = (framePos != pad.GetData().end()) ? framePos - pad.GetData().begin() : 0u;
-    // make a copy of data that will serve as axis frame and put it in front of data vector
-    if (pad.GetData()[frameDataID]->GetType() == "ratio") {
-      pad.GetData().insert(
-        pad.GetData().begin(),
-        std::make_shared<Plot::Pad::Ratio>(
-          *std::dynamic_pointer_cast<Plot::Pad::Ratio>(pad.GetData()[frameDataID])));
-    } else {
-      pad.GetData().insert(pad.GetData().begin(),
-                           std::make_shared<Plot::Pad::Data>(*pad.GetData()[frameDataID]));
+    // the plan stays untouched, so legend entries are collected in copies of the legend boxes
+    vector<shared_ptr<Plot::Pad::LegendBox>> legendBoxes;
+    for (auto& box : pad.GetLegendBoxes()) {
+      legendBoxes.push_back(std::make_shared<Plot::Pad::LegendBox>(*box));
     }
-    pad.GetData()[0]->SetLegendLable(""); // axis frame should not appear in legend
 
     TH1* axisHist_ptr{nullptr};
     string drawingOptions = "";
     uint16_t dataIndex{};
     for (auto& data : pad.GetData()) {
       if (data->GetDrawingOptions()) drawingOptions += *data->GetDrawingOptions();
+      auto& dataStyle = padStyle.data[dataIndex];
+      const optional<decimation_t>& decimation = dataStyle.decimation;
       // obtain a copy of the current data
       // retrieve the actual pointer to the data
       auto processData = [&, padID = padID](auto&& data_ptr) {
         using data_type = std::decay_t<decltype(data_ptr)>;
         data_ptr->SetTitle(""); // FIXME: only make this invisible but dont remove this metadata
 
-        optional<drawing_options_t> defaultDrawingOption = data->GetDrawingOptionAlias();
-
-        if (!data->GetDrawingOptions()) {
-          // FIXME: avoid code duplication here by implementing this in more clever way
-          if constexpr (std::is_convertible_v<data_type, data_ptr_t_hist_2d>) {
-            if (!defaultDrawingOption) {
-              if (pad.GetDefaultDrawingOptionHist2d())
-                defaultDrawingOption = pad.GetDefaultDrawingOptionHist2d();
-              else if (padDefaults.GetDefaultDrawingOptionHist2d())
-                defaultDrawingOption = padDefaults.GetDefaultDrawingOptionHist2d();
-            }
-
-            if (defaultDrawingOption && defaultDrawingOpions_Hist2d.find(*defaultDrawingOption) != defaultDrawingOpions_Hist2d.end()) {
-              drawingOptions += defaultDrawingOpions_Hist2d.at(*defaultDrawingOption);
-            }
-          } else if constexpr (std::is_convertible_v<data_type, data_ptr_t_hist_1d>) {
-            if (!defaultDrawingOption)
-              defaultDrawingOption = (pad.GetDefaultDrawingOptionHist())
-                                       ? pad.GetDefaultDrawingOptionHist()
-                                     : (padDefaults.GetDefaultDrawingOptionHist())
-                                       ? padDefaults.GetDefaultDrawingOptionHist()
-                                       : std::nullopt;
-
-            if (defaultDrawingOption && defaultDrawingOpions_Hist.find(*defaultDrawingOption) != defaultDrawingOpions_Hist.end()) {
-              drawingOptions += defaultDrawingOpions_Hist.at(*defaultDrawingOption);
-            }
-          } else if constexpr (std::is_convertible_v<data_type, data_ptr_t_graph_1d>) {
-            if (!defaultDrawingOption)
-              defaultDrawingOption = (pad.GetDefaultDrawingOptionGraph())
-                                       ? pad.GetDefaultDrawingOptionGraph()
-                                     : (padDefaults.GetDefaultDrawingOptionGraph())
-                                       ? padDefaults.GetDefaultDrawingOptionGraph()
-                                       : std::nullopt;
-
-            if (defaultDrawingOption && defaultDrawingOpions_Graph.find(*defaultDrawingOption) != defaultDrawingOpions_Graph.end()) {
-              drawingOptions += defaultDrawingOpions_Graph.at(*defaultDrawingOption);
-            }
-          }
+        // default drawing options were resolved in the plan (they are empty if the user specified options)
+        if constexpr (std::is_convertible_v<data_type, data_ptr_t_hist_2d>) {
+          drawingOptions += dataStyle.drawingOptionsHist2d;
+        } else if constexpr (std::is_convertible_v<data_type, data_ptr_t_hist_1d>) {
+          drawingOptions += dataStyle.drawingOptionsHist;
+        } else if constexpr (std::is_convertible_v<data_type, data_ptr_t_graph_1d>) {
+          drawingOptions += dataStyle.drawingOptionsGraph;
         }
 
-        if (data->GetType() == "ratio") {
-          // retrieve the actual pointer to the denominator data
-          auto processDenominator = [&](auto&& denom_data_ptr) {
-            using denom_data_type = std::decay_t<decltype(denom_data_ptr)>;
-            if constexpr (std::is_convertible_v<data_type, data_ptr_t_hist>) {
-              if constexpr (std::is_convertible_v<denom_data_type, data_ptr_t_hist>) {
-                string divideOpt = (std::dynamic_pointer_cast<Plot::Pad::Ratio>(data)->GetIsCorrelated()) ? "B"
-                                                                                                          : "";
-                if (!data_ptr->Divide(data_ptr, denom_data_ptr, 1., 1., divideOpt.data())) {
-                  WARNING(
-                    "Could not divide histograms properly. Trying approximated division "
-                    "via spline interpolation. Errors will not be fully correct!");
-                  DivideHistosInterpolated(data_ptr, denom_data_ptr);
-                }
-                if constexpr (std::is_convertible_v<data_type, data_ptr_t_hist_2d>)
-                  data_ptr->GetZaxis()->SetTitle("ratio");
-                else if constexpr (std::is_convertible_v<data_type, data_ptr_t_hist_1d>)
-                  data_ptr->GetYaxis()->SetTitle("ratio");
-              } else if constexpr (std::is_convertible_v<denom_data_type, data_ptr_t_graph>) {
-                ERROR("Cannot divide histogram by graph.");
-                //DivideHistGraphInterpolated(data_ptr, denom_data_ptr);
-              }
-            } else if constexpr (std::is_convertible_v<data_type, data_ptr_t_graph_1d>) {
-              if constexpr (std::is_convertible_v<denom_data_type, data_ptr_t_graph_1d>) {
-                if (!DivideGraphs(data_ptr, denom_data_ptr)) // first try if exact division is possible
-                {
-                  WARNING(
-                    "In general graphs cannot be divided. Trying approximated division "
-                    "via spline interpolation. Errors will not be fully correct!");
-                  DivideGraphsInterpolated(data_ptr, denom_data_ptr);
+        if (const auto& operation = std::dynamic_pointer_cast<Plot::Pad::Operation>(data)) {
+          // the second operand is only read, so a copy is needed only for projections
+          bool isOperandShared = !operation->GetProjInfoOperand() || mProjectionCache;
+
+          // retrieve the actual pointer to the second operand
+          auto processOperand = [&](auto&& operand_ptr) {
+            using operand_type = std::decay_t<decltype(operand_ptr)>;
+            constexpr bool isSupportedData = std::is_convertible_v<data_type, data_ptr_t_hist> || std::is_convertible_v<data_type, data_ptr_t_graph_1d>;
+            constexpr bool isSupportedOperand = std::is_convertible_v<operand_type, data_ptr_t_hist> || std::is_convertible_v<operand_type, data_ptr_t_graph_1d>;
+            if constexpr (isSupportedData && isSupportedOperand) {
+              ApplyOperation(data_ptr, operand_ptr, operation->GetOperation(), operation->GetIsCorrelated(), isOperandShared);
+              if constexpr (std::is_convertible_v<data_type, data_ptr_t_hist>) {
+                const char* axisTitle = (operation->GetOperation() == division) ? "ratio" : (operation->GetOperation() == pull) ? "pull" : nullptr;
+                if constexpr (std::is_convertible_v<data_type, data_ptr_t_hist_2d>) {
+                  if (axisTitle) data_ptr->GetZaxis()->SetTitle(axisTitle);
+                } else {
+                  if (axisTitle) data_ptr->GetYaxis()->SetTitle(axisTitle);
                 }
-              } else if constexpr (std::is_convertible_v<denom_data_type, data_ptr_t_hist_1d>) {
-                ERROR("Cannot divide graph by histogram.");
-                //DivideGraphHistInterpolated(data_ptr, denom_data_ptr);
               }
             } else {
-              ERROR("Unsupported division");
+              ERROR("Unsupported operation");
             }
-            delete denom_data_ptr;
+            if (!isOperandShared) delete operand_ptr;
           };
 
-          auto data_denom = std::dynamic_pointer_cast<Plot::Pad::Ratio>(data);
-          auto rawDenomData = GetDataClone(dataBuffer.at(data_denom->GetDenomIdentifier()).at(data_denom->GetDenomName()).get(), data_denom->GetProjInfoDenom());
+          auto rawOperandData = GetDataClone(getData(operation->GetOperandIdentifier(), operation->GetOperandName()), operation->GetProjInfoOperand(), isOperandShared);
 
-          if (rawDenomData) {
-            std::visit(processDenominator, *rawDenomData);
+          if (rawOperandData) {
+            std::visit(processOperand, *rawOperandData);
           } else {
             fail = true;
           }
-        } // end ratio code
+        } // end operation code
 
         // modify content (FIXME: this should be steered differently)
         // FIXME: probably this should be done after setting ranges but axis ranges depend on
@@ -333,6 +311,10 @@ shared_ptr<TCanvas> PlotPainter::GeneratePlot(Plot& plot, const unordered_map<st
           }
           if constexpr (std::is_convertible_v<data_type, data_ptr_t_hist>) {
             axisHist_ptr = data_ptr;
+          } else if constexpr (std::is_convertible_v<data_type, data_ptr_t_graph_1d>) {
+            // only the axis histogram of the graph is needed (the graph itself may be shared)
+            axisHist_ptr = (TH1*)data_ptr->GetHistogram()->Clone();
+            axisHist_ptr->SetDirectory(0);
           } else {
             data_ptr->Draw();
             axisHist_ptr = data_ptr->GetHistogram();
@@ -359,83 +341,82 @@ shared_ptr<TCanvas> PlotPainter::GeneratePlot(Plot& plot, const unordered_map<st
             optional<float_t> textSizeTitle = textSize;
             optional<float_t> textSizeLable = textSize;
 
-            // first apply default pad values and then settings for this specific pad
-            for (Plot::Pad& curPad : {std::ref(padDefaults), std::ref(plot.GetPads()[padID])}) {
-              if (curPad.GetAxes().find(axisLable) != curPad.GetAxes().end()) {
-                auto axisLayout = curPad[axisLable];
-                if (axisLayout.GetTitle()) axis_ptr->SetTitle((*axisLayout.GetTitle()).data());
+            // the plan holds the pad default axes with the settings of this specific pad on top
+            auto axisIt = padStyle.axes.find(axisLable);
+            if (axisIt != padStyle.axes.end()) {
+              auto& axisLayout = axisIt->second;
+              if (axisLayout.GetTitle()) axis_ptr->SetTitle((*axisLayout.GetTitle()).data());
 
-                if (axisLayout.GetTitleFont()) textFontTitle = axisLayout.GetTitleFont();
-                if (axisLayout.GetLableFont()) textFontLable = axisLayout.GetLableFont();
+              if (axisLayout.GetTitleFont()) textFontTitle = axisLayout.GetTitleFont();
+              if (axisLayout.GetLableFont()) textFontLable = axisLayout.GetLableFont();
 
-                if (axisLayout.GetTitleColor()) textColorTitle = axisLayout.GetTitleColor();
-                if (axisLayout.GetLableColor()) textColorLable = axisLayout.GetLableColor();
+              if (axisLayout.GetTitleColor()) textColorTitle = axisLayout.GetTitleColor();
+              if (axisLayout.GetLableColor()) textColorLable = axisLayout.GetLableColor();
 
-                if (axisLayout.GetTitleSize()) textSizeTitle = axisLayout.GetTitleSize();
-                if (axisLayout.GetLableSize()) textSizeLable = axisLayout.GetLableSize();
+              if (axisLayout.GetTitleSize()) textSizeTitle = axisLayout.GetTitleSize();
+              if (axisLayout.GetLableSize()) textSizeLable = axisLayout.GetLableSize();
 
-                if (axisLayout.GetTitleCenter())
-                  axis_ptr->CenterTitle(*axisLayout.GetTitleCenter());
-                if (axisLayout.GetLableCenter())
-                  axis_ptr->CenterLabels(*axisLayout.GetLableCenter());
+              if (axisLayout.GetTitleCenter())
+                axis_ptr->CenterTitle(*axisLayout.GetTitleCenter());
+              if (axisLayout.GetLableCenter())
+                axis_ptr->CenterLabels(*axisLayout.GetLableCenter());
 
-                if (axisLayout.GetAxisColor()) axis_ptr->SetAxisColor(*axisLayout.GetAxisColor());
+              if (axisLayout.GetAxisColor()) axis_ptr->SetAxisColor(*axisLayout.GetAxisColor());
 
-                if (axisLayout.GetTitleOffset())
-                  axis_ptr->SetTitleOffset(*axisLayout.GetTitleOffset());
-                if (axisLayout.GetLableOffset())
-                  axis_ptr->SetLabelOffset(*axisLayout.GetLableOffset());
+              if (axisLayout.GetTitleOffset())
+                axis_ptr->SetTitleOffset(*axisLayout.GetTitleOffset());
+              if (axisLayout.GetLableOffset())
+                axis_ptr->SetLabelOffset(*axisLayout.GetLableOffset());
 
-                if (axisLayout.GetTickLength())
-                  axis_ptr->SetTickLength(*axisLayout.GetTickLength());
-                if (axisLayout.GetMaxDigits()) axis_ptr->SetMaxDigits(*axisLayout.GetMaxDigits());
+              if (axisLayout.GetTickLength())
+                axis_ptr->SetTickLength(*axisLayout.GetTickLength());
+              if (axisLayout.GetMaxDigits()) axis_ptr->SetMaxDigits(*axisLayout.GetMaxDigits());
 
-                if (axisLayout.GetNumDivisions())
-                  axis_ptr->SetNdivisions(*axisLayout.GetNumDivisions());
+              if (axisLayout.GetNumDivisions())
+                axis_ptr->SetNdivisions(*axisLayout.GetNumDivisions());
 
-                if (axisLayout.GetLog()) {
-                  if (axisLable == 'X') {
-                    pad_ptr->SetLogx(*axisLayout.GetLog());
-                  } else if (axisLable == 'Y') {
-                    pad_ptr->SetLogy(*axisLayout.GetLog());
-                  } else if (axisLable == 'Z') {
-                    pad_ptr->SetLogz(*axisLayout.GetLog());
-                  }
-                }
-                if (axisLayout.GetGrid()) {
-                  if (axisLable == 'X')
-                    pad_ptr->SetGridx(*axisLayout.GetGrid());
-                  else if (axisLable == 'Y')
-                    pad_ptr->SetGridy(*axisLayout.GetGrid());
-                }
-                if (axisLayout.GetOppositeTicks()) {
-                  if (axisLable == 'X')
-                    pad_ptr->SetTickx(*axisLayout.GetOppositeTicks());
-                  else if (axisLable == 'Y')
-                    pad_ptr->SetTicky(*axisLayout.GetOppositeTicks());
-                }
-                if (axisLayout.GetTimeFormat()) {
-                  axis_ptr->SetTimeDisplay(1);
-                  axis_ptr->SetTimeFormat((*axisLayout.GetTimeFormat()).data());
-                }
-                if (axisLayout.GetTickOrientation()) {
-                  axis_ptr->SetTicks((*axisLayout.GetTickOrientation()).data());
+              if (axisLayout.GetLog()) {
+                if (axisLable == 'X') {
+                  pad_ptr->SetLogx(*axisLayout.GetLog());
+                } else if (axisLable == 'Y') {
+                  pad_ptr->SetLogy(*axisLayout.GetLog());
+                } else if (axisLable == 'Z') {
+                  pad_ptr->SetLogz(*axisLayout.GetLog());
                 }
+              }
+              if (axisLayout.GetGrid()) {
+                if (axisLable == 'X')
+                  pad_ptr->SetGridx(*axisLayout.GetGrid());
+                else if (axisLable == 'Y')
+                  pad_ptr->SetGridy(*axisLayout.GetGrid());
+              }
+              if (axisLayout.GetOppositeTicks()) {
+                if (axisLable == 'X')
+                  pad_ptr->SetTickx(*axisLayout.GetOppositeTicks());
+                else if (axisLable == 'Y')
+                  pad_ptr->SetTicky(*axisLayout.GetOppositeTicks());
+              }
+              if (axisLayout.GetTimeFormat()) {
+                axis_ptr->SetTimeDisplay(1);
+                axis_ptr->SetTimeFormat((*axisLayout.GetTimeFormat()).data());
+              }
+              if (axisLayout.GetTickOrientation()) {
+                axis_ptr->SetTicks((*axisLayout.GetTickOrientation()).data());
+              }
 
-                if (axisLayout.GetMinRange() || axisLayout.GetMaxRange()) {
-                  pad_ptr->Update(); // needed here so current user ranges correct
-                  double_t curRangeMin = (axisLable == 'X')
-                                           ? pad_ptr->GetUxmin()
-                                           : ((axisLable == 'Y') ? pad_ptr->GetUymin() : axisHist_ptr->GetMinimum());
-                  double_t curRangeMax = (axisLable == 'X')
-                                           ? pad_ptr->GetUxmax()
-                                           : ((axisLable == 'Y') ? pad_ptr->GetUymax() : axisHist_ptr->GetMaximum());
+              if (axisLayout.GetMinRange() || axisLayout.GetMaxRange()) {
+                pad_ptr->Update(); // needed here so current user ranges correct
+                double_t curRangeMin = (axisLable == 'X')
+                                         ? pad_ptr->GetUxmin()
+                                         : ((axisLable == 'Y') ? pad_ptr->GetUymin() : axisHist_ptr->GetMinimum());
+                double_t curRangeMax = (axisLable == 'X')
+                                         ? pad_ptr->GetUxmax()
+                                         : ((axisLable == 'Y') ? pad_ptr->GetUymax() : axisHist_ptr->GetMaximum());
 
-                  double_t rangeMin = (axisLayout.GetMinRange()) ? *axisLayout.GetMinRange() : curRangeMin;
-                  double_t rangeMax = (axisLayout.GetMaxRange()) ? *axisLayout.GetMaxRange() : curRangeMax;
+                double_t rangeMin = (axisLayout.GetMinRange()) ? *axisLayout.GetMinRange() : curRangeMin;
+                double_t rangeMax = (axisLayout.GetMaxRange()) ? *axisLayout.GetMaxRange() : curRangeMax;
 
-                  axis_ptr->SetRangeUser(rangeMin, rangeMax);
-                }
+                axis_ptr->SetRangeUser(rangeMin, rangeMax);
               }
             }
             if (textFontTitle) axis_ptr->SetTitleFont(*textFontTitle);
@@ -447,8 +428,7 @@ shared_ptr<TCanvas> PlotPainter::GeneratePlot(Plot& plot, const unordered_map<st
           }
 
           // right after drawing the axis, put reference line if requested
-          optional<string> refFunc = (pad.GetRefFunc()) ? pad.GetRefFunc() : padDefaults.GetRefFunc();
-          if (refFunc) {
+          if (auto& refFunc = padStyle.refFunc) {
             TF1* line = new TF1("line", (*refFunc).data(), data_ptr->GetXaxis()->GetXmin(),
                                 data_ptr->GetXaxis()->GetXmax());
             line->SetLineColor(kBlack);
@@ -459,52 +439,31 @@ shared_ptr<TCanvas> PlotPainter::GeneratePlot(Plot& plot, const unordered_map<st
           pad_ptr->Update();
         } else {
           // define data appearance
-          if (auto markerColor = get_first(data->GetMarkerColor(),
-                                           pick(dataIndex, pad.GetDefaultMarkerColors()),
-                                           pick(dataIndex, padDefaults.GetDefaultMarkerColors()),
-                                           pick(dataIndex, padColorGradient))) {
+          if (auto markerColor = get_first(dataStyle.marker.color, pick(dataIndex, padColorGradient))) {
             data_ptr->SetMarkerColor(*markerColor);
           }
-          if (auto markerStyle = get_first(data->GetMarkerStyle(),
-                                           pick(dataIndex, pad.GetDefaultMarkerStyles()),
-                                           pick(dataIndex, padDefaults.GetDefaultMarkerStyles()))) {
+          if (auto& markerStyle = dataStyle.marker.style) {
             data_ptr->SetMarkerStyle(*markerStyle);
           }
-          if (auto markerSize = get_first(data->GetMarkerSize(),
-                                          pad.GetDefaultMarkerSize(),
-                                          padDefaults.GetDefaultMarkerSize())) {
+          if (auto& markerSize = dataStyle.marker.scale) {
             data_ptr->SetMarkerSize(*markerSize);
           }
-          if (auto lineColor = get_first(data->GetLineColor(),
-                                         pick(dataIndex, pad.GetDefaultLineColors()),
-                                         pick(dataIndex, padDefaults.GetDefaultLineColors()),
-                                         pick(dataIndex, padColorGradient))) {
+          if (auto lineColor = get_first(dataStyle.line.color, pick(dataIndex, padColorGradient))) {
             data_ptr->SetLineColor(*lineColor);
           }
-          if (auto lineStyle = get_first(data->GetLineStyle(),
-                                         pick(dataIndex, pad.GetDefaultLineStyles()),
-                                         pick(dataIndex, padDefaults.GetDefaultLineStyles()))) {
+          if (auto& lineStyle = dataStyle.line.style) {
             data_ptr->SetLineStyle(*lineStyle);
           }
-          if (auto lineWidth = get_first(data->GetLineWidth(),
-                                         pad.GetDefaultLineWidth(),
-                                         padDefaults.GetDefaultLineWidth())) {
+          if (auto& lineWidth = dataStyle.line.scale) {
             data_ptr->SetLineWidth(*lineWidth);
           }
-          if (auto fillColor = get_first(data->GetFillColor(),
-                                         pick(dataIndex, pad.GetDefaultFillColors()),
-                                         pick(dataIndex, padDefaults.GetDefaultFillColors()),
-                                         pick(dataIndex, padColorGradient))) {
+          if (auto fillColor = get_first(dataStyle.fill.color, pick(dataIndex, padColorGradient))) {
             data_ptr->SetFillColor(*fillColor);
           }
-          if (auto fillStyle = get_first(data->GetFillStyle(),
-                                         pick(dataIndex, pad.GetDefaultFillStyles()),
-                                         pick(dataIndex, padDefaults.GetDefaultFillStyles()))) {
+          if (auto& fillStyle = dataStyle.fill.style) {
             data_ptr->SetFillStyle(*fillStyle);
           }
-          if (auto fillOpacity = get_first(data->GetFillOpacity(),
-                                           pad.GetDefaultFillOpacity(),
-                                           padDefaults.GetDefaultFillOpacity())) {
+          if (auto& fillOpacity = dataStyle.fill.scale) {
             data_ptr->SetFillColor(TColor::GetColorTransparent(data_ptr->GetFillColor(), *fillOpacity));
           }
 
@@ -530,10 +489,16 @@ shared_ptr<TCanvas> PlotPainter::GeneratePlot(Plot& plot, const unordered_map<st
           } else if constexpr (std::is_convertible_v<data_type, data_ptr_t_func>) {
             data_ptr->SetRange(rangeMinX, rangeMaxX);
           } else if constexpr (std::is_convertible_v<data_type, data_ptr_t_graph>) {
-            SetGraphRange((TGraph*)data_ptr, data->GetMinRangeX(), data->GetMaxRangeX());
+            if constexpr (std::is_convertible_v<data_type, data_ptr_t_graph_1d>) {
+              SetGraphRange(data_ptr, data->GetMinRangeX(), data->GetMaxRangeX(), data->GetKeepOrder().value_or(false));
+            }
           } else {
             data_ptr->GetXaxis()->SetRangeUser(rangeMinX, rangeMaxX);
           }
+          if constexpr (std::is_convertible_v<data_type, data_ptr_t_graph_1d>) {
+            // reduce the graph to what can be resolved in the pad (ranges are already applied)
+            if (decimation) DecimateGraph((TGraph*)data_ptr, *decimation, pad_ptr);
+          }
           if constexpr (std::is_convertible_v<data_type, data_ptr_t_hist_2d>) {
             data_ptr->GetYaxis()->SetRangeUser(rangeMinY, rangeMaxY);
             // do not draw the Z axis a second time!
@@ -556,9 +521,8 @@ shared_ptr<TCanvas> PlotPainter::GeneratePlot(Plot& plot, const unordered_map<st
             // explicit user choice overrides this
             if (data->GetLegendID()) legendID = *data->GetLegendID();
 
-            auto& boxVector = pad.GetLegendBoxes();
-            if (legendID > 0u && legendID <= boxVector.size()) {
-              boxVector[legendID - 1]->AddEntry(*data->GetLegendLable(), data_ptr->GetName());
+            if (legendID > 0u && legendID <= legendBoxes.size()) {
+              legendBoxes[legendID - 1]->AddEntry(*data->GetLegendLable(), data_ptr->GetName());
             } else {
               ERROR(R"(Invalid legend lable ({}) specified for data "{}" in "{}".)", legendID,
                     data->GetName(), data->GetInputID());
@@ -570,7 +534,13 @@ shared_ptr<TCanvas> PlotPainter::GeneratePlot(Plot& plot, const unordered_map<st
         drawingOptions = "SAME "; // next data should be drawn to same pad
       };
 
-      optional<data_ptr_t> rawData = GetDataClone(dataBuffer.at(data->GetInputID()).at(data->GetName()).get(), data->GetProjInfo());
+      // data that are only styled can be drawn directly (histograms defining the frame are always modified)
+      TObject* inputData = getData(data->GetInputID(), data->GetName());
+      bool isFrame = (dataIndex == 0);
+      bool isDecimated = inputData && decimation && *decimation != no_decimation && inputData->InheritsFrom(TGraph::Class());
+      bool shareData = allowSharedData && inputData && !IsModified(*data) && !isDecimated && (!isFrame || inputData->InheritsFrom(TGraph::Class())) && mSharedData.find(inputData) == mSharedData.end();
+      if (shareData && !isFrame) mSharedData.insert(inputData);
+      optional<data_ptr_t> rawData = GetDataClone(inputData, data->GetProjInfo(), shareData);
       if (rawData) {
         std::visit(processData, *rawData);
       } else {
@@ -589,7 +559,7 @@ shared_ptr<TCanvas> PlotPainter::GeneratePlot(Plot& plot, const unordered_map<st
     }
     // now place legends, textboxes and shapes
     uint8_t legendIndex{1u};
-    for (auto& box : pad.GetLegendBoxes()) {
+    for (auto& box : legendBoxes) {
       string legendName = "LegendBox_" + std::to_string(legendIndex);
       box->MergeLegendEntries(); // apply individual user settings on top of automatic entries
       TPave* legend = GenerateBox(box, pad_ptr);
@@ -614,10 +584,7 @@ shared_ptr<TCanvas> PlotPainter::GeneratePlot(Plot& plot, const unordered_map<st
       }
     }
 
-    bool redrawAxes = (pad.GetRedrawAxes())
-                        ? *pad.GetRedrawAxes()
-                        : ((padDefaults.GetRedrawAxes()) ? *padDefaults.GetRedrawAxes() : false);
-    if (redrawAxes && axisHist_ptr) axisHist_ptr->Draw("SAME AXIS");
+    if (padStyle.redrawAxes && axisHist_ptr) axisHist_ptr->Draw("SAME AXIS");
 
     pad_ptr->Modified();
     pad_ptr->Update();
@@ -657,10 +624,20 @@ TPave* PlotPainter::GenerateBox(
 
     vector<string> lines;
     if constexpr (isLegend) {
-      std::for_each(box->GetEntries().begin(), box->GetEntries().end(),
-                    [&lines](const auto& entry) {
-                      if (entry.GetLable()) lines.push_back(*entry.GetLable());
-                    });
+      // fill in the placeholders once such that the lines can be used for sizing and drawing the legend
+      for (auto& entry : box->GetEntries()) {
+        if (!entry.GetLable()) continue;
+        lines.push_back(*entry.GetLable());
+        if (entry.GetRefDataName()) {
+          // FIXME: this gives always the first -> problem when drawing the same histogram twice!
+          TNamed* data_ptr = (TNamed*)pad->FindObject((*entry.GetRefDataName()).data());
+          if (data_ptr) {
+            lines.back() = FormatLable(lines.back(), data_ptr, pad);
+          } else {
+            ERROR(R"(Object belonging to legend entry "{}" not found.)", lines.back());
+          }
+        }
+      }
     } else {
       // split text string to vector
       string delimiter{" // "};
@@ -698,18 +675,7 @@ TPave* PlotPainter::GenerateBox(
     double_t lineHeightPixel{text_size};
     if (text_font % 10 <= 2) lineHeightPixel = GetTextSizePixel(text_size);
 
-    uint8_t lineID{};
     for (auto& line : lines) {
-      if constexpr (isLegend) {
-        auto& entry = box->GetEntries()[lineID];
-        if (entry.GetRefDataName()) {
-          // FIXME: this gives always the first -> problem when drawing the same histogram twice!
-          TNamed* data_ptr = (TNamed*)pad->FindObject((*entry.GetRefDataName()).data());
-          if (!data_ptr) ERROR(R"(Object belonging to legend entry "{}" not found.)", line);
-          ReplacePlaceholders(line, data_ptr);
-        }
-      }
-
       // determine width and height of line to find max width and height (per column)
       TLatex textLine(0, 0, line.data());
       textLine.SetTextFont(text_font);
@@ -720,7 +686,6 @@ TPave* PlotPainter::GenerateBox(
       if (width > legendWidthPixelPerColumn[iColumn]) legendWidthPixelPerColumn[iColumn] = width;
       ++iColumn;
       iColumn %= nColumns;
-      ++lineID;
     }
     for (auto& length : legendWidthPixelPerColumn)
       legendWidthPixel += length;
@@ -760,41 +725,24 @@ TPave* PlotPainter::GenerateBox(
     double_t upperLeftY{box->GetYPosition()};
 
     if (box->IsAutoPlacement()) {
-      pad->cd();
-      pad->Update();
       double_t lowerLeftX{};
       double_t lowerLeftY{};
       // minimum distance of box to objects and ticks (in units of tick length)
       double_t fractionOfTickLenght{0.9};
       double_t marginX = fractionOfTickLenght * gStyle->GetTickLength("Y") * (pad->GetUxmax() - pad->GetUxmin()) / (pad->GetX2() - pad->GetX1());
       double_t marginY = fractionOfTickLenght * gStyle->GetTickLength("X") * (pad->GetUymax() - pad->GetUymin()) / (pad->GetY2() - pad->GetY1());
-      bool foundPosition = false;
-
-      // draw temporary boxes to exclude areas outside of the coordinate system
-      TBox marginsBottom(
-        pad->GetX1(), pad->GetY1(), pad->GetX2(),
-        pad->GetUymin() + gStyle->GetTickLength("X") * (pad->GetUymax() - pad->GetUymin()));
-      TBox marginsTop(
-        pad->GetX1(),
-        pad->GetUymax() - gStyle->GetTickLength("X") * (pad->GetUymax() - pad->GetUymin()),
-        pad->GetX2(), pad->GetY2());
-      TBox marginsLeft(
-        pad->GetX1(), pad->GetY1(),
-        pad->GetUxmin() + gStyle->GetTickLength("Y") * (pad->GetUxmax() - pad->GetUxmin()),
-        pad->GetY2());
-      TBox marginsRight(
-        pad->GetUxmax() - gStyle->GetTickLength("Y") * (pad->GetUxmax() - pad->GetUxmin()),
-        pad->GetY1(), pad->GetX2(), pad->GetY2());
-      marginsBottom.Draw("SAME");
-      marginsTop.Draw("SAME");
-      marginsLeft.Draw("SAME");
-      marginsRight.Draw("SAME");
-
-      // find box position that does not collide with any of the drawn objects
-      for (TObject* o : *pad->GetListOfPrimitives()) {
-        foundPosition = pad->PlaceBox(o, totalWidthNDC + 2 * marginX, totalHeightNDC + 2 * marginY,
-                                      lowerLeftX, lowerLeftY);
+      // the drawn objects are rasterized only once per pad (the tick lengths are excluded as well)
+      auto& boxPlacer = mBoxPlacers[pad];
+      if (!boxPlacer) {
+        pad->cd();
+        pad->Update();
+        double_t tickMarginX = gStyle->GetTickLength("Y") * (pad->GetUxmax() - pad->GetUxmin()) / (pad->GetX2() - pad->GetX1());
+        double_t tickMarginY = gStyle->GetTickLength("X") * (pad->GetUymax() - pad->GetUymin()) / (pad->GetY2() - pad->GetY1());
+        boxPlacer = std::make_unique<BoxPlacer>(pad, tickMarginX, tickMarginY);
       }
+
+      // find box position that does not collide with any of the drawn objects or previously placed boxes
+      bool foundPosition = boxPlacer->FindPosition(totalWidthNDC + 2 * marginX, totalHeightNDC + 2 * marginY, lowerLeftX, lowerLeftY);
       if (foundPosition) {
         upperLeftX = lowerLeftX + 2 * marginX;
         upperLeftY = lowerLeftY + totalHeightNDC + 2 * marginY;
@@ -804,18 +752,16 @@ TPave* PlotPainter::GenerateBox(
         upperLeftX = (pad->GetUxmin() - pad->GetX1()) / (pad->GetX2() - pad->GetX1()) + (1 + 1 / fractionOfTickLenght) * marginX;
         upperLeftY = (pad->GetUymax() - pad->GetY1()) / (pad->GetY2() - pad->GetY1()) - (1 + 1 / fractionOfTickLenght) * marginY;
       }
-      // now remove temporary boxes again
-      pad->GetListOfPrimitives()->Remove(&marginsBottom);
-      pad->GetListOfPrimitives()->Remove(&marginsTop);
-      pad->GetListOfPrimitives()->Remove(&marginsLeft);
-      pad->GetListOfPrimitives()->Remove(&marginsRight);
-      // pad->DrawCollideGrid();
     } else if (box->IsUserCoordinates()) {
       // convert user coordinates to NDC
       pad->Update();
       upperLeftX = (upperLeftX - pad->GetX1()) / (pad->GetX2() - pad->GetX1());
       upperLeftY = (upperLeftY - pad->GetY1()) / (pad->GetY2() - pad->GetY1());
     }
+    // boxes that are placed automatically later on must not overlap with this one
+    if (auto boxPlacerIt = mBoxPlacers.find(pad); boxPlacerIt != mBoxPlacers.end()) {
+      boxPlacerIt->second->MarkOccupied(upperLeftX, upperLeftY - totalHeightNDC, upperLeftX + totalWidthNDC, upperLeftY);
+    }
 
     if constexpr (isLegend) {
       TLegend* legend = new TLegend(upperLeftX, upperLeftY - totalHeightNDC,
@@ -831,8 +777,9 @@ TPave* PlotPainter::GenerateBox(
       if (textSize) legend->SetTextSize(*textSize);
       if (textFont) legend->SetTextFont(*textFont);
 
-      for (auto entry : box->GetEntries()) {
-        string lable = entry.GetLable() ? *entry.GetLable() : ""; // fixme: this is equal to lines[i]
+      size_t lineID{};
+      for (auto& entry : box->GetEntries()) {
+        string lable = entry.GetLable() ? lines[lineID++] : "";
         string drawStyle = entry.GetDrawStyle() ? *entry.GetDrawStyle() : "";
 
         // TLegendEntry* curEntry = legend->AddEntry((TObject*)nullptr, lable.data(),
@@ -951,15 +898,97 @@ TPave* PlotPainter::GenerateBox(
   return returnBox;
 }
 
+//**************************************************************************************************
+/**
+ * Check if drawing the data requires changes of the content (not only of the layout).
+ * Every step in GeneratePlot that changes the content must be covered here, since only the layout of shared data is restored.
+ */
+//**************************************************************************************************
+bool PlotPainter::IsModified(const Plot::Pad::Data& data)
+{
+  bool isOperation = dynamic_cast<const Plot::Pad::Operation*>(&data);
+  bool isScaled = data.GetNormMode() || data.GetScaleFactor();
+  bool hasContours = data.GetContours() || data.GetNContours();
+  bool isSmoothed = data.GetDrawingOptions() && str_contains(*data.GetDrawingOptions(), "smooth");
+  // graphs are sorted and their points outside the range are removed
+  bool hasRange = data.GetMinRangeX() || data.GetMaxRangeX();
+  return isOperation || isScaled || hasContours || isSmoothed || hasRange;
+}
+
+//**************************************************************************************************
+/**
+ * Remember layout of input data that are drawn directly such that it can be restored once the plot is saved.
+ */
+//**************************************************************************************************
+template <typename T>
+void PlotPainter::KeepSharedDataState(T* data_ptr)
+{
+  TAttLine line;
+  TAttMarker marker;
+  TAttFill fill;
+  data_ptr->TAttLine::Copy(line);
+  data_ptr->TAttMarker::Copy(marker);
+  data_ptr->TAttFill::Copy(fill);
+  string title = data_ptr->GetTitle();
+  std::function<void()> restoreRanges = []() {};
+  if constexpr (std::is_base_of_v<TH1, T>) {
+    double_t minimum = data_ptr->GetMinimumStored();
+    double_t maximum = data_ptr->GetMaximumStored();
+    vector<std::tuple<TAxis*, int32_t, int32_t, bool>> axisRanges;
+    for (TAxis* axis : {data_ptr->GetXaxis(), data_ptr->GetYaxis()}) {
+      axisRanges.push_back({axis, axis->GetFirst(), axis->GetLast(), axis->TestBit(TAxis::kAxisRange)});
+    }
+    restoreRanges = [data_ptr, minimum, maximum, axisRanges]() {
+      data_ptr->SetMinimum(minimum);
+      data_ptr->SetMaximum(maximum);
+      for (auto& [axis, first, last, hasRange] : axisRanges) {
+        if (hasRange) {
+          axis->SetRange(first, last);
+        } else {
+          axis->SetRange();
+        }
+      }
+    };
+  } else if constexpr (std::is_base_of_v<TGraph, T>) {
+    double_t minimum = data_ptr->GetMinimum();
+    double_t maximum = data_ptr->GetMaximum();
+    // the points themselves cannot be restored, so make sure they were not touched
+    int32_t nPoints = data_ptr->GetN();
+    bool isSorted = std::is_sorted(data_ptr->GetX(), data_ptr->GetX() + nPoints);
+    restoreRanges = [data_ptr, minimum, maximum, nPoints, isSorted]() {
+      data_ptr->SetMinimum(minimum);
+      data_ptr->SetMaximum(maximum);
+      if (data_ptr->GetN() != nPoints || std::is_sorted(data_ptr->GetX(), data_ptr->GetX() + data_ptr->GetN()) != isSorted) {
+        ERROR(R"(Points of input data "{}" were modified while drawing it directly.)", data_ptr->GetName());
+      }
+    };
+  }
+  mRestoreActions.push_back([data_ptr, line, marker, fill, title, restoreRanges]() {
+    line.Copy(*data_ptr);
+    marker.Copy(*data_ptr);
+    fill.Copy(*data_ptr);
+    data_ptr->SetTitle(title.data());
+    restoreRanges();
+  });
+}
+
 //**************************************************************************************************
 /**
  * Functions to retrieve a copy or projection of the stored data properly casted it to its actual ROOT type.
+ * With shareData, the stored data (or cached projection) are returned directly instead of a copy.
+ * Without projection cache, projections are always new objects.
  */
 //**************************************************************************************************
-optional<data_ptr_t> PlotPainter::GetDataClone(TObject* obj, const std::optional<Plot::Pad::Data::proj_info_t>& projInfo)
+optional<data_ptr_t> PlotPainter::GetDataClone(TObject* obj, const std::optional<Plot::Pad::Data::proj_info_t>& projInfo, bool shareData)
 {
   if (obj) {
     if (projInfo) {
+      if (mProjectionCache) {
+        if (TObject* projection = GetCachedProjection(obj, *projInfo)) {
+          return GetDataClone<TH2, TH1>(projection, shareData);
+        }
+        return std::nullopt;
+      }
       bool addDirStatus = TH1::AddDirectoryStatus();
       TH1::AddDirectory(false);
       string name = ((TNamed*)obj)->GetName();
@@ -969,11 +998,12 @@ optional<data_ptr_t> PlotPainter::GetDataClone(TObject* obj, const std::optional
         TH1::AddDirectory(addDirStatus);
         return returnPointer;
       } else {
+        TH1::AddDirectory(addDirStatus);
         ERROR(R"(Projection failed for "{}".)", ((TNamed*)obj)->GetName());
       }
     } else {
       // TProfile2D is TH2, TH2 is TH1, TProfile is TH1
-      if (auto returnPointer = GetDataClone<TProfile2D, TH2, TProfile, TH1, TGraph2D, TGraph, TF2, TF1>(obj)) {
+      if (auto returnPointer = GetDataClone<TProfile2D, TH2, TProfile, TH1, TGraph2D, TGraph, TF2, TF1>(obj, shareData)) {
         return returnPointer;
       } else {
         ERROR(R"(Input data "{}" is of unsupported type {}.)", ((TNamed*)obj)->GetName(), obj->ClassName());
@@ -983,20 +1013,53 @@ optional<data_ptr_t> PlotPainter::GetDataClone(TObject* obj, const std::optional
   return std::nullopt;
 }
 
+//**************************************************************************************************
+/**
+ * Get projection of stored data from the cache. Missing projections are created and added to the cache.
+ */
+//**************************************************************************************************
+TObject* PlotPainter::GetCachedProjection(TObject* obj, const Plot::Pad::Data::proj_info_t& projInfo)
+{
+  projection_key_t key{obj, projInfo.dims, projInfo.ranges, projInfo.isUserCoord};
+  auto projectionIt = mProjectionCache->find(key);
+  if (projectionIt != mProjectionCache->end()) return projectionIt->second.get();
+
+  bool addDirStatus = TH1::AddDirectoryStatus();
+  TH1::AddDirectory(false);
+  auto projection = GetProjection(obj, projInfo);
+  TH1::AddDirectory(addDirStatus);
+  if (!projection) {
+    ERROR(R"(Projection failed for "{}".)", ((TNamed*)obj)->GetName());
+    return nullptr;
+  }
+  TObject* projectionPtr = std::visit([](auto&& ptr) { return (TObject*)ptr; }, *projection);
+  string name = string(((TNamed*)obj)->GetName()) + projInfo.GetNameSuffix();
+  ((TNamed*)projectionPtr)->SetName(name.data());
+  (*mProjectionCache)[key].reset(projectionPtr);
+  return projectionPtr;
+}
+
 template <typename T>
-optional<data_ptr_t> PlotPainter::GetDataClone(TObject* obj)
+optional<data_ptr_t> PlotPainter::GetDataClone(TObject* obj, bool shareData)
 {
   if (obj && obj->InheritsFrom(T::Class())) {
+    // functions always get their range modified and 2d graphs do not provide their stored z range
+    if constexpr (std::is_base_of_v<TH1, T> || std::is_base_of_v<TGraph, T>) {
+      if (shareData) {
+        KeepSharedDataState((T*)obj);
+        return (T*)obj;
+      }
+    }
     return (T*)obj->Clone();
   }
   return std::nullopt;
 }
 
 template <typename T, typename Next, typename... Rest>
-optional<data_ptr_t> PlotPainter::GetDataClone(TObject* obj)
+optional<data_ptr_t> PlotPainter::GetDataClone(TObject* obj, bool shareData)
 {
-  if (auto returnPointer = GetDataClone<T>(obj)) return returnPointer;
-  return GetDataClone<Next, Rest...>(obj);
+  if (auto returnPointer = GetDataClone<T>(obj, shareData)) return returnPointer;
+  return GetDataClone<Next, Rest...>(obj, shareData);
 }
 
 optional<data_ptr_t> PlotPainter::GetProjection(TObject* obj, Plot::Pad::Data::proj_info_t projInfo)
@@ -1023,11 +1086,17 @@ optional<data_ptr_t> PlotPainter::GetProjection(TObject* obj, Plot::Pad::Data::p
       int maxBin = (projInfo.isUserCoord) ? histPtr->GetAxis(rangeDim)->FindBin(std::get<2>(rangeTuple)) : static_cast<int>(std::get<2>(rangeTuple));
       histPtr->GetAxis(rangeDim)->SetRange(minBin, maxBin);
     }
+    optional<data_ptr_t> projection;
     if (projInfo.dims.size() == 2) {
-      return histPtr->Projection(projInfo.dims[1], projInfo.dims[0]);
+      projection = histPtr->Projection(projInfo.dims[1], projInfo.dims[0]);
     } else if (projInfo.dims.size() == 1) {
-      return histPtr->Projection(projInfo.dims[0]);
+      projection = histPtr->Projection(projInfo.dims[0]);
     }
+    // leave the input data untouched
+    for (int i = 0; i < histPtr->GetNdimensions(); ++i) {
+      histPtr->GetAxis(i)->SetRange();
+    }
+    return projection;
   } else if (obj->InheritsFrom(TH3::Class())) {
     TH3* histPtr = (TH3*)obj;
     // first reset all ranges in case this histogram was previously used
@@ -1044,12 +1113,18 @@ optional<data_ptr_t> PlotPainter::GetProjection(TObject* obj, Plot::Pad::Data::p
       int maxBin = (projInfo.isUserCoord) ? GetAxis(histPtr, rangeDim)->FindBin(std::get<2>(rangeTuple)) : static_cast<int>(std::get<2>(rangeTuple));
       GetAxis(histPtr, rangeDim)->SetRange(minBin, maxBin);
     }
+    optional<data_ptr_t> projection;
     if (projInfo.dims.size() == 2) {
       // get string if it is "xy" or "yx" or "zx"...
-      return histPtr->Project3D((GetAxisStr(projInfo.dims[1]) + GetAxisStr(projInfo.dims[0])).data());
+      projection = histPtr->Project3D((GetAxisStr(projInfo.dims[1]) + GetAxisStr(projInfo.dims[0])).data());
     } else if (projInfo.dims.size() == 1) {
-      return histPtr->Project3D(GetAxisStr(projInfo.dims[0]).data());
+      projection = histPtr->Project3D(GetAxisStr(projInfo.dims[0]).data());
+    }
+    // leave the input data untouched
+    for (int i = 0; i < 3; ++i) {
+      GetAxis(histPtr, i)->SetRange();
     }
+    return projection;
   } else if (obj->InheritsFrom(TH2::Class())) {
     TH2* histPtr = (TH2*)obj;
     if (projInfo.dims.size() > 1) {
@@ -1112,151 +1187,404 @@ std::string PlotPainter::GetAxisStr(int i)
 
 //**************************************************************************************************
 /**
- * Helper-function dividing two TGraphs.
- * This is meant only for the rare use case, where the x values of all points are are exactly the
- * same. In this scenario the values and errors can be calculated exactly. If this condition is not
- * met, the function will return false.
+ * Get spline interpolation of 1d graph or histogram.
+ * Interpolations of shared data (buffered input data or their cached projections) are kept in the cache
+ * such that a denominator used by many ratios is interpolated only once.
  */
 //**************************************************************************************************
-bool PlotPainter::DivideGraphs(TGraph* numerator, TGraph* denominator)
+template <typename T>
+shared_ptr<const interpolation_t> PlotPainter::GetInterpolation(T* data, bool isShared)
 {
-  // first check if graphs indeed have the same x values
-  for (int32_t i = 0; i < numerator->GetN(); ++i) {
-    if (numerator->GetX()[i] != denominator->GetX()[i]) return false;
+  bool isCached = isShared && mInterpolationCache;
+  if (isCached) {
+    auto interpolationIt = mInterpolationCache->find(data);
+    if (interpolationIt != mInterpolationCache->end()) return interpolationIt->second;
   }
-  // now divide
-  for (int32_t i = 0; i < numerator->GetN(); ++i) {
-    bool illegalDivision = false;
-    if (denominator->GetY()[i] == 0.) {
-      ERROR("Dividing by zero!");
-      illegalDivision = true;
+  vector<tuple<double_t, double_t, double_t>> points; // x, y, ey
+  if constexpr (std::is_convertible_v<T*, TGraph*>) {
+    points.reserve(data->GetN());
+    for (int32_t i = 0; i < data->GetN(); ++i) {
+      points.emplace_back(data->GetX()[i], data->GetY()[i], data->GetErrorY(i));
+    }
+  } else {
+    points.reserve(data->GetNbinsX());
+    for (int32_t i = 1; i <= data->GetNbinsX(); ++i) {
+      points.emplace_back(data->GetBinCenter(i), data->GetBinContent(i), data->GetBinError(i));
     }
-    numerator->GetY()[i] = (illegalDivision) ? 0. : numerator->GetY()[i] / denominator->GetY()[i];
-    numerator->GetEY()[i] = (illegalDivision)
-                              ? 0.
-                              : numerator->GetEY()[i] / denominator->GetY()[i] + denominator->GetEY()[i] * numerator->GetY()[i] / (denominator->GetY()[i] * denominator->GetY()[i]);
   }
-  return true;
+  auto interpolation = std::make_shared<const interpolation_t>(BuildInterpolation(points));
+  if (isCached) (*mInterpolationCache)[data] = interpolation;
+  return interpolation;
 }
 
 //**************************************************************************************************
 /**
- * Helper-function dividing two TGraphs.
- * This is only a proxy for the ratio as it depends on an interpolation. Therefore also the
- * uncertainties are not fully correct!
+ * Build cubic spline through points (x, y, ey). Points with the same x value are only used once.
  */
 //**************************************************************************************************
-void PlotPainter::DivideGraphsInterpolated(TGraph* numerator, TGraph* denominator)
+interpolation_t PlotPainter::BuildInterpolation(vector<tuple<double_t, double_t, double_t>>& points)
 {
-  TSpline3 denSpline("denSpline", denominator);
+  auto getX = [](const tuple<double_t, double_t, double_t>& point) { return std::get<0>(point); };
+  std::stable_sort(points.begin(), points.end(), [&](auto& a, auto& b) { return getX(a) < getX(b); });
+  points.erase(std::unique(points.begin(), points.end(), [&](auto& a, auto& b) { return getX(a) == getX(b); }), points.end());
+
+  interpolation_t interpolation;
+  size_t nKnots = points.size();
+  for (auto& [x, y, ey] : points) {
+    interpolation.x.push_back(x);
+    interpolation.y.push_back(y);
+    interpolation.ey.push_back(ey);
+  }
+  interpolation.b.resize(nKnots);
+  interpolation.c.resize(nKnots);
+  interpolation.d.resize(nKnots);
+  if (nKnots == 2u) {
+    interpolation.b[0] = interpolation.b[1] = (interpolation.y[1] - interpolation.y[0]) / (interpolation.x[1] - interpolation.x[0]);
+  } else if (nKnots > 2u) {
+    TSpline3 spline("spline", interpolation.x.data(), interpolation.y.data(), nKnots);
+    double_t xKnot, yKnot;
+    for (size_t i = 0; i < nKnots; ++i) {
+      spline.GetCoeff(i, xKnot, yKnot, interpolation.b[i], interpolation.c[i], interpolation.d[i]);
+    }
+  }
+  return interpolation;
+}
 
-  int32_t nPoints = numerator->GetN();
+//**************************************************************************************************
+/**
+ * Evaluate interpolation at x. The cursor holds the knot of the last evaluation, so points evaluated in
+ * increasing order only move it forward. Beyond the knots the outermost polynomials are extrapolated.
+ * The uncertainty is interpolated linearly between the knots and kept constant beyond them.
+ */
+//**************************************************************************************************
+double_t PlotPainter::EvalInterpolation(const interpolation_t& interpolation, double_t x, size_t& cursor, double_t& error)
+{
+  const vector<double_t>& knots = interpolation.x;
+  if (knots.empty()) {
+    error = 0.;
+    return 0.;
+  }
+  if (cursor >= knots.size() || (cursor > 0u && x < knots[cursor])) {
+    cursor = std::max<size_t>(std::upper_bound(knots.begin(), knots.end(), x) - knots.begin(), 1u) - 1u;
+  }
+  while (cursor + 1u < knots.size() && x >= knots[cursor + 1u]) ++cursor;
 
-  double_t* x = numerator->GetX();
-  double_t* y = numerator->GetY();
-  double_t* ey = numerator->GetEY();
+  double_t dx = x - knots[cursor];
+  if (dx <= 0. || cursor + 1u == knots.size()) {
+    error = interpolation.ey[cursor];
+  } else {
+    error = interpolation.ey[cursor] + (interpolation.ey[cursor + 1u] - interpolation.ey[cursor]) * dx / (knots[cursor + 1u] - knots[cursor]);
+  }
+  return interpolation.y[cursor] + dx * (interpolation.b[cursor] + dx * (interpolation.c[cursor] + dx * interpolation.d[cursor]));
+}
 
-  for (int32_t i = 0; i < nPoints; ++i) {
-    double_t denomValue = denominator->Eval(x[i], &denSpline);
-    double_t newValue = 0.;
-    double_t newError = 0.;
-    if (denomValue) {
-      newValue = y[i] / denomValue;
-      newError = ey[i] / denomValue; // Only proxy. Ignoring error of denominator!
-    } else {
-      ERROR("Dividing by zero!");
-    }
-    y[i] = newValue;
-    ey[i] = newError;
+//**************************************************************************************************
+/**
+ * Evaluate interpolation (value and uncertainty) at all x values, which are visited in increasing order.
+ */
+//**************************************************************************************************
+void PlotPainter::EvalInterpolation(const interpolation_t& interpolation, const double_t* x, size_t nPoints, double_t* y, double_t* ey)
+{
+  vector<size_t> order(nPoints);
+  std::iota(order.begin(), order.end(), 0u);
+  if (!std::is_sorted(x, x + nPoints)) {
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return x[a] < x[b]; });
+  }
+  size_t cursor = 0u;
+  for (size_t i : order) {
+    y[i] = EvalInterpolation(interpolation, x[i], cursor, ey[i]);
   }
 }
 
 //**************************************************************************************************
 /**
- * Helper-function dividing hist by graph.
- * This is only a proxy for the ratio as it depends on an interpolation. Therefore also the
- * uncertainties are not fully correct!
+ * Check if histograms have identical binning.
  */
 //**************************************************************************************************
-void PlotPainter::DivideHistGraphInterpolated(TH1* numerator, TGraph* denominator)
+bool PlotPainter::HaveSameBinning(TH1* hist1, TH1* hist2)
 {
-  TGraph numeratorGraph(numerator);
-  DivideGraphsInterpolated(&numeratorGraph, denominator);
-  // FXIME: numerator graph must be put in hist afterwards!
+  if (hist1->GetDimension() != hist2->GetDimension() || hist1->GetNcells() != hist2->GetNcells()) return false;
+  vector<std::pair<TAxis*, TAxis*>> axes{{hist1->GetXaxis(), hist2->GetXaxis()}, {hist1->GetYaxis(), hist2->GetYaxis()}, {hist1->GetZaxis(), hist2->GetZaxis()}};
+  for (int32_t i = 0; i < hist1->GetDimension(); ++i) {
+    auto [axis1, axis2] = axes[i];
+    if (axis1->GetNbins() != axis2->GetNbins()) return false;
+    for (int32_t bin = 1; bin <= axis1->GetNbins() + 1; ++bin) {
+      if (axis1->GetBinLowEdge(bin) != axis2->GetBinLowEdge(bin)) return false;
+    }
+  }
+  return true;
 }
 
 //**************************************************************************************************
 /**
- * Helper-function dividing graph by hist.
- * This is only a proxy for the ratio as it depends on an interpolation. Therefore also the
- * uncertainties are not fully correct!
+ * Combine histogram with second operand (histogram or graph) bin by bin. If the binning differs, the
+ * second operand is interpolated at the bin centers (only possible for 1d data).
  */
 //**************************************************************************************************
-void PlotPainter::DivideGraphHistInterpolated(TGraph* numerator, TH1* denominator)
+template <typename T>
+void PlotPainter::ApplyOperation(TH1* hist, T* operand, operation_t operation, bool isCorrelated, bool isOperandShared)
 {
-  TGraph denominatorGraph(denominator);
-  DivideGraphsInterpolated(numerator, &denominatorGraph);
+  // profiles do not store plain bin contents
+  if (hist->InheritsFrom(TProfile::Class()) || hist->InheritsFrom(TProfile2D::Class())) {
+    if constexpr (std::is_convertible_v<T*, TH1*>) {
+      if (operation == division && hist->Divide(hist, operand, 1., 1., (isCorrelated) ? "B" : "")) return;
+    }
+    ERROR("Profiles can only be divided by histograms with the same binning.");
+    return;
+  }
+
+  int32_t nCells = hist->GetNcells();
+  vector<double_t> values(nCells);
+  vector<double_t> errors(nCells);
+  vector<double_t> operandValues(nCells);
+  vector<double_t> operandErrors(nCells);
+  for (int32_t i = 0; i < nCells; ++i) {
+    values[i] = hist->GetBinContent(i);
+    errors[i] = hist->GetBinError(i);
+  }
+
+  bool isAligned = false;
+  if constexpr (std::is_convertible_v<T*, TH1*>) {
+    isAligned = HaveSameBinning(hist, operand);
+    if (isAligned) {
+      for (int32_t i = 0; i < nCells; ++i) {
+        operandValues[i] = operand->GetBinContent(i);
+        operandErrors[i] = operand->GetBinError(i);
+      }
+    }
+  }
+  if (!isAligned) {
+    bool isOneDimensional = (hist->GetDimension() == 1);
+    if constexpr (std::is_convertible_v<T*, TH1*>) isOneDimensional = isOneDimensional && (operand->GetDimension() == 1);
+    if (!isOneDimensional) {
+      ERROR("Histograms with different binning can only be combined in one dimension.");
+      return;
+    }
+    WARNING("Binning of the operands differs. Using spline interpolation of the second operand.");
+    vector<double_t> binCenters(nCells);
+    for (int32_t i = 0; i < nCells; ++i) {
+      binCenters[i] = hist->GetBinCenter(i);
+    }
+    EvalInterpolation(*GetInterpolation(operand, isOperandShared), binCenters.data(), nCells, operandValues.data(), operandErrors.data());
+  }
+
+  Arithmetic::Apply(operation, isCorrelated, nCells, values.data(), errors.data(), errors.data(), operandValues.data(), operandErrors.data(), operandErrors.data());
+
+  double_t nEntries = hist->GetEntries();
+  if (hist->GetSumw2N() == 0) hist->Sumw2();
+  for (int32_t i = 0; i < nCells; ++i) {
+    hist->SetBinContent(i, values[i]);
+    hist->SetBinError(i, errors[i]);
+  }
+  hist->SetEntries(nEntries);
 }
 
 //**************************************************************************************************
 /**
- * Helper-function dividing two 1d histograms with different binning.
- * This is only a proxy for the ratio as it depends on an interpolation. Therefore also the
- * uncertainties are not fully correct!
+ * Combine graph with second operand (graph or 1d histogram) point by point. If the x values differ, the
+ * second operand is interpolated at the x values of the graph.
  */
 //**************************************************************************************************
-void PlotPainter::DivideHistosInterpolated(TH1* numerator, TH1* denominator)
+template <typename T>
+void PlotPainter::ApplyOperation(TGraph* graph, T* operand, operation_t operation, bool isCorrelated, bool isOperandShared)
 {
-  TGraph denominatorGraph(denominator);
-  TSpline3 denominatorSpline(denominator);
-
-  for (int32_t i = 1; i <= numerator->GetNbinsX(); ++i) {
-    double_t numeratorValue{numerator->GetBinContent(i)};
-    double_t numeratorError{numerator->GetBinError(i)};
-    double_t x{numerator->GetBinCenter(i)};
-    double_t denomValue{denominatorGraph.Eval(x, &denominatorSpline)};
-    double_t newValue{};
-    double_t newError{};
-    if (denomValue) {
-      newValue = numeratorValue / denomValue;
-      // uncertainty of denominator is not taken into account (cannot be extracted from spline)
-      newError = numeratorError / denomValue;
-    } else {
-      // ERROR("Dividing by zero in bin {}!", i);
+  int32_t nPoints = graph->GetN();
+  // uncertainties of TGraphErrors or TGraphAsymmErrors (none for plain TGraph)
+  auto getErrorsY = [](TGraph* graph) -> std::pair<double_t*, double_t*> {
+    if (graph->GetEY()) return {graph->GetEY(), graph->GetEY()};
+    return {graph->GetEYlow(), graph->GetEYhigh()};
+  };
+  auto [eyLow, eyHigh] = getErrorsY(graph);
+  vector<double_t> noErrors;
+  if (!eyLow || !eyHigh) {
+    noErrors.resize(nPoints);
+    eyLow = eyHigh = noErrors.data();
+  }
+
+  const double_t* operandValues{};
+  const double_t* operandErrorsLow{};
+  const double_t* operandErrorsHigh{};
+  if constexpr (std::is_convertible_v<T*, TGraph*>) {
+    if (operand->GetN() == nPoints && std::equal(graph->GetX(), graph->GetX() + nPoints, operand->GetX())) {
+      operandValues = operand->GetY();
+      std::tie(operandErrorsLow, operandErrorsHigh) = getErrorsY(operand);
+    }
+  }
+  vector<double_t> interpolatedValues;
+  vector<double_t> interpolatedErrors;
+  if (!operandValues) {
+    if constexpr (std::is_convertible_v<T*, TH1*>) {
+      if (operand->GetDimension() != 1) {
+        ERROR("Graphs can only be combined with 1d histograms.");
+        return;
+      }
     }
-    numerator->SetBinContent(i, newValue);
-    numerator->SetBinError(i, newError);
+    WARNING("The x values of the operands differ. Using spline interpolation of the second operand.");
+    interpolatedValues.resize(nPoints);
+    interpolatedErrors.resize(nPoints);
+    EvalInterpolation(*GetInterpolation(operand, isOperandShared), graph->GetX(), nPoints, interpolatedValues.data(), interpolatedErrors.data());
+    operandValues = interpolatedValues.data();
+    operandErrorsLow = operandErrorsHigh = interpolatedErrors.data();
   }
+
+  Arithmetic::Apply(operation, isCorrelated, nPoints, graph->GetY(), eyLow, eyHigh, operandValues, operandErrorsLow, operandErrorsHigh);
 }
 
 //**************************************************************************************************
 /**
  * Deletes data points of graph beyond cutoff values.
+ * The graph is sorted in x such that the points within the range are found via binary search and moved
+ * to the front of all arrays at once. With keepOrder the graph is not sorted and the points outside the
+ * range are dropped wherever they are. Graph types with additional per-point arrays remove their points one by one.
  */
 //**************************************************************************************************
-void PlotPainter::SetGraphRange(TGraph* graph, optional<double_t> min, optional<double_t> max)
+void PlotPainter::SetGraphRange(TGraph* graph, optional<double_t> min, optional<double_t> max, bool keepOrder)
 {
-  // sort the points first for the following algorithm to work properly
-  graph->Sort();
-
-  int16_t pointsToRemoveHigh{};
-  int16_t pointsToRemoveLow{};
+  if (!min && !max) return;
+  int32_t nPoints = graph->GetN();
+  if (!keepOrder && !std::is_sorted(graph->GetX(), graph->GetX() + nPoints)) graph->Sort();
+
+  double_t* x = graph->GetX();
+  auto isInRange = [&](int32_t i) { return (!min || x[i] >= *min) && (!max || x[i] < *max); };
+  if (graph->IsA() != TGraph::Class() && graph->IsA() != TGraphErrors::Class() && graph->IsA() != TGraphAsymmErrors::Class()) {
+    for (int32_t i = nPoints - 1; i >= 0; --i) {
+      if (!isInRange(i)) graph->RemovePoint(i);
+    }
+    return;
+  }
+  if (keepOrder) {
+    vector<int32_t> keptPoints;
+    keptPoints.reserve(nPoints);
+    for (int32_t i = 0; i < nPoints; ++i) {
+      if (isInRange(i)) keptPoints.push_back(i);
+    }
+    if ((int32_t)keptPoints.size() < nPoints) KeepPoints(graph, keptPoints);
+    return;
+  }
 
-  for (int16_t i = 0; i < graph->GetN(); ++i) {
-    if (min && graph->GetX()[i] < *min) {
-      ++pointsToRemoveLow;
+  int32_t begin = (min) ? std::lower_bound(x, x + nPoints, *min) - x : 0;
+  int32_t end = (max) ? std::lower_bound(x + begin, x + nPoints, *max) - x : nPoints;
+  if (begin > 0) {
+    for (auto pointArray : GetPointArrays(graph)) {
+      std::copy(pointArray + begin, pointArray + end, pointArray);
     }
-    if (max && graph->GetX()[i] >= *max) {
-      ++pointsToRemoveHigh;
+  }
+  if (end - begin < nPoints) graph->Set(end - begin);
+}
+
+//**************************************************************************************************
+/**
+ * Get all arrays of graph holding per-point values (coordinates and errors).
+ * Only complete for TGraph, TGraphErrors and TGraphAsymmErrors.
+ */
+//**************************************************************************************************
+set<double_t*> PlotPainter::GetPointArrays(TGraph* graph)
+{
+  set<double_t*> pointArrays{graph->GetX(), graph->GetY(), graph->GetEX(), graph->GetEY(), graph->GetEXlow(), graph->GetEXhigh(), graph->GetEYlow(), graph->GetEYhigh()};
+  pointArrays.erase(nullptr);
+  return pointArrays;
+}
+
+//**************************************************************************************************
+/**
+ * Move the kept points (ascending indices) to the front of all arrays of the graph and drop the rest.
+ */
+//**************************************************************************************************
+void PlotPainter::KeepPoints(TGraph* graph, const vector<int32_t>& keptPoints)
+{
+  for (auto pointArray : GetPointArrays(graph)) {
+    for (size_t i = 0; i < keptPoints.size(); ++i) {
+      pointArray[i] = pointArray[keptPoints[i]];
     }
   }
+  graph->Set(keptPoints.size());
+}
 
-  for (int16_t i = 0; i < pointsToRemoveHigh; ++i) {
-    graph->RemovePoint(graph->GetN() - 1);
+//**************************************************************************************************
+/**
+ * Reduces graph with many more points than pixel columns in the pad to the points that can actually be seen.
+ * Points that are kept retain their errors. The points are processed in their stored order (sorted in x unless the order is kept).
+ * min_max keeps per pixel column the first and last point as well as the ones reaching lowest and highest
+ * (including their error bars), lttb selects two points per pixel column via largest triangle three buckets.
+ */
+//**************************************************************************************************
+void PlotPainter::DecimateGraph(TGraph* graph, decimation_t decimation, TPad* pad)
+{
+  if (decimation == no_decimation) return;
+  if (graph->IsA() != TGraph::Class() && graph->IsA() != TGraphErrors::Class() && graph->IsA() != TGraphAsymmErrors::Class()) {
+    WARNING(R"(Decimation is not supported for graph "{}" of type {}.)", graph->GetName(), graph->ClassName());
+    return;
   }
-  for (int16_t i = 0; i < pointsToRemoveLow; ++i) {
-    graph->RemovePoint(0);
+  // pad coordinates are logarithmic in case of log axes
+  auto toPadX = [pad](double_t x) { return (pad->GetLogx()) ? ((x > 0.) ? std::log10(x) : pad->GetUxmin()) : x; };
+  auto toPadY = [pad](double_t y) { return (pad->GetLogy()) ? ((y > 0.) ? std::log10(y) : pad->GetUymin()) : y; };
+
+  int32_t nPoints = graph->GetN();
+  int32_t nColumns = std::abs(pad->XtoPixel(pad->GetUxmax()) - pad->XtoPixel(pad->GetUxmin())) + 1;
+  if (nPoints <= 4 * nColumns) return; // nothing to gain
+
+  double_t* x = graph->GetX();
+  double_t* y = graph->GetY();
+  double_t* eyLow = graph->GetEYlow();
+  double_t* eyHigh = graph->GetEYhigh();
+
+  vector<int32_t> keptPoints;
+  keptPoints.reserve(4 * nColumns);
+  if (decimation == min_max) {
+    int32_t begin{};
+    while (begin < nPoints) {
+      int32_t column = pad->XtoPixel(toPadX(x[begin]));
+      int32_t end = begin;
+      int32_t lowest = begin;
+      int32_t highest = begin;
+      while (end < nPoints && pad->XtoPixel(toPadX(x[end])) == column) {
+        if (y[end] - ((eyLow) ? eyLow[end] : 0.) < y[lowest] - ((eyLow) ? eyLow[lowest] : 0.)) lowest = end;
+        if (y[end] + ((eyHigh) ? eyHigh[end] : 0.) > y[highest] + ((eyHigh) ? eyHigh[highest] : 0.)) highest = end;
+        ++end;
+      }
+      // keep the original order of the points
+      array<int32_t, 4> columnPoints{begin, lowest, highest, end - 1};
+      std::sort(columnPoints.begin(), columnPoints.end());
+      std::unique_copy(columnPoints.begin(), columnPoints.end(), std::back_inserter(keptPoints));
+      begin = end;
+    }
+  } else if (decimation == lttb) {
+    // first and last point are always kept, the ones in between are split into equally sized buckets
+    int32_t nBuckets = 2 * nColumns;
+    double_t bucketSize = (nPoints - 2) / (double_t)nBuckets;
+    auto bucketBegin = [&](int32_t bucket) { return std::min(nPoints - 1, 1 + (int32_t)(bucket * bucketSize)); };
+    keptPoints.push_back(0);
+    for (int32_t bucket{}; bucket < nBuckets; ++bucket) {
+      // the third corner of the triangle is the average of the next bucket
+      int32_t nextBegin = bucketBegin(bucket + 1);
+      int32_t nextEnd = (bucket + 1 < nBuckets) ? bucketBegin(bucket + 2) : nPoints;
+      double_t avgX{};
+      double_t avgY{};
+      for (int32_t i = nextBegin; i < nextEnd; ++i) {
+        avgX += toPadX(x[i]);
+        avgY += toPadY(y[i]);
+      }
+      avgX /= (nextEnd - nextBegin);
+      avgY /= (nextEnd - nextBegin);
+
+      double_t prevX = toPadX(x[keptPoints.back()]);
+      double_t prevY = toPadY(y[keptPoints.back()]);
+      int32_t selected = bucketBegin(bucket);
+      double_t maxArea{-1.};
+      for (int32_t i = bucketBegin(bucket); i < nextBegin; ++i) {
+        double_t area = std::abs((prevX - avgX) * (toPadY(y[i]) - prevY) - (prevX - toPadX(x[i])) * (avgY - prevY));
+        if (area > maxArea) {
+          maxArea = area;
+          selected = i;
+        }
+      }
+      keptPoints.push_back(selected);
+    }
+    keptPoints.push_back(nPoints - 1);
   }
+
+  // errors are moved along with the points
+  KeepPoints(graph, keptPoints);
 }
 
 //**************************************************************************************************
@@ -1320,21 +1648,44 @@ std::tuple<uint32_t, uint32_t> PlotPainter::GetTextDimensions(TLatex& text)
   uint32_t width{};
   uint32_t height{};
   int16_t font{text.GetTextFont()};
+  TVirtualPad* pad = gROOT->GetSelectedPad();
+
+  // the latex layout only needs to be done once for the same text in a pad of the same size
+  // (the size of the pad itself in pixel, not the one of the canvas window it belongs to)
+  uint32_t padWidthPixel = (pad) ? std::lround(pad->GetWw() * pad->GetAbsWNDC()) : 0u;
+  uint32_t padHeightPixel = (pad) ? std::lround(pad->GetWh() * pad->GetAbsHNDC()) : 0u;
+  tuple<string, int16_t, float_t, uint32_t, uint32_t> key{text.GetTitle(), font, text.GetTextSize(), padWidthPixel, padHeightPixel};
+  auto dimensionsIt = gTextDimensionsCache.find(key);
+  if (dimensionsIt != gTextDimensionsCache.end()) {
+    ++gTextDimensionsCacheHits;
+    return dimensionsIt->second;
+  }
+  ++gTextDimensionsCacheMisses;
 
   if (font % 10 <= 2) {
     text.GetBoundingBox(width, height);
   } else {
     TLatex textBox{text};
     textBox.SetTextFont(font - 1);
-    TVirtualPad* pad = gROOT->GetSelectedPad();
     double_t dy{pad->AbsPixeltoY(0) - pad->AbsPixeltoY((int32_t)(text.GetTextSize()))};
     double_t textSize{dy / (pad->GetY2() - pad->GetY1())};
     textBox.SetTextSize(textSize);
     textBox.GetBoundingBox(width, height);
   }
+  gTextDimensionsCache[key] = {width, height};
   return {width, height};
 }
 
+//**************************************************************************************************
+/**
+ * Returns number of hits and misses of the text dimensions cache.
+ */
+//**************************************************************************************************
+std::tuple<uint64_t, uint64_t> PlotPainter::GetTextDimensionsCacheStats()
+{
+  return {gTextDimensionsCacheHits, gTextDimensionsCacheMisses};
+}
+
 //**************************************************************************************************
 /**
  * Converts NDC text size to pixel.
@@ -1354,63 +1705,167 @@ float_t PlotPainter::GetTextSizePixel(float_t textsizeNDC)
 
 //**************************************************************************************************
 /**
- * Function to replace placeholders in lables.
+ * Get lable split into literal text and placeholders. Each lable is parsed only once per plot.
  */
 //**************************************************************************************************
-void PlotPainter::ReplacePlaceholders(string& str, TNamed* data_ptr)
+const lable_template_t& PlotPainter::GetLableTemplate(const string& lable)
 {
-  std::regex words_regex("<.*?>");
-  auto words_begin = std::sregex_iterator(str.begin(), str.end(), words_regex);
-  auto words_end = std::sregex_iterator();
-
-  for (std::sregex_iterator match = words_begin; match != words_end; ++match) {
-    std::string match_str = (*match).str();
+  if (auto templateIt = mLableTemplates.find(lable); templateIt != mLableTemplates.end()) {
+    return templateIt->second;
+  }
+  lable_template_t& lableTemplate = mLableTemplates[lable];
+  auto addText = [&lableTemplate](const string& text) {
+    if (text.empty()) return;
+    if (lableTemplate.empty() || lableTemplate.back().placeholder != placeholder_t::none) {
+      lableTemplate.push_back({placeholder_t::none, text});
+    } else {
+      lableTemplate.back().text += text;
+    }
+  };
 
-    string format{};
+  size_t pos{};
+  while (pos < lable.size()) {
+    size_t begin = lable.find('<', pos);
+    size_t end = (begin == string::npos) ? string::npos : lable.find('>', begin);
+    if (end == string::npos) {
+      addText(lable.substr(pos));
+      break;
+    }
+    addText(lable.substr(pos, begin - pos));
+    pos = end + 1;
 
     // check if user specified different formatting (e.g. via <mean[%2.6]>)
-    std::regex format_regex("\\[.*?\\]");
-    auto format_it = std::sregex_iterator(match_str.begin(), match_str.end(), format_regex);
-    if (format_it != std::sregex_iterator()) {
-      format = (*format_it).str();
-      format = format.substr(1, format.size() - 2);
+    string match = lable.substr(begin + 1, end - begin - 1);
+    string key = match.substr(0, match.find('['));
+    key.erase(remove(key.begin(), key.end(), ' '), key.end());
+    auto placeholderIt = gPlaceholders.find(key);
+    if (placeholderIt == gPlaceholders.end()) {
+      addText(lable.substr(begin, pos - begin));
+      continue;
+    }
+    string format{};
+    if (size_t formatBegin = match.find('['); formatBegin != string::npos) {
+      format = match.substr(formatBegin + 1, match.find(']', formatBegin) - formatBegin - 1);
     }
     // allow printf style and protect against wrong usage
     format.erase(remove(format.begin(), format.end(), '%'), format.end());
     format.erase(remove(format.begin(), format.end(), ' '), format.end());
 
     // if no valid formatting pattern is given, fall back to 'general' mode
-    if (!(str_contains(format, "e") || str_contains(format, "f") || str_contains(format, "g") || str_contains(format, "E") || str_contains(format, "F") || str_contains(format, "G"))) {
+    if (format.find_first_of("efgEFG") == string::npos) {
       format = format + "g";
     }
-    format = "{:" + format + "}";
-
-    string replace_str;
-    if (match_str.find("name") != string::npos) {
-      replace_str = data_ptr->GetName();
-      replace_str = replace_str.substr(0, replace_str.find(gNameGroupSeparator));
-    } else if (match_str.find("title") != string::npos) {
-      replace_str = data_ptr->GetTitle();
+    lableTemplate.push_back({placeholderIt->second, "{:" + format + "}"});
+  }
+  return lableTemplate;
+}
+
+//**************************************************************************************************
+/**
+ * Fill placeholders in lable with the properties of the data drawn in pad.
+ */
+//**************************************************************************************************
+string PlotPainter::FormatLable(const string& lable, TNamed* data_ptr, TPad* pad)
+{
+  const lable_template_t& lableTemplate = GetLableTemplate(lable);
+  string formattedLable;
+  for (auto& [placeholder, text] : lableTemplate) {
+    if (placeholder == placeholder_t::none) {
+      formattedLable += text;
+    } else if (placeholder == placeholder_t::name) {
+      string name = data_ptr->GetName();
+      formattedLable += name.substr(0, name.find(gNameGroupSeparator));
+    } else if (placeholder == placeholder_t::title) {
+      formattedLable += data_ptr->GetTitle();
     } else if (data_ptr->InheritsFrom(TH1::Class())) {
       try {
-        if (match_str.find("entries") != string::npos) {
-          replace_str = fmt::format(format, ((TH1*)data_ptr)->GetEntries());
-        } else if (match_str.find("integral") != string::npos) {
-          replace_str = fmt::format(format, ((TH1*)data_ptr)->Integral());
-        } else if (match_str.find("mean") != string::npos) {
-          replace_str = fmt::format(format, ((TH1*)data_ptr)->GetMean());
-        } else if (match_str.find("maximum") != string::npos) {
-          replace_str = fmt::format(format, ((TH1*)data_ptr)->GetMaximum());
-        } else if (match_str.find("minimum") != string::npos) {
-          replace_str = fmt::format(format, ((TH1*)data_ptr)->GetMinimum());
-        }
+        formattedLable += fmt::format(text, GetStatistic((TH1*)data_ptr, placeholder, pad));
       } catch (...) {
-        ERROR(R"(Incompatible format string in "{}".)", match_str);
-        replace_str = match_str;
+        ERROR(R"(Incompatible format string "{}" in "{}".)", text, lable);
+      }
+    }
+  }
+  return formattedLable;
+}
+
+//**************************************************************************************************
+/**
+ * Get statistical property of histogram. Each property is determined only once per histogram and pad.
+ */
+//**************************************************************************************************
+double_t PlotPainter::GetStatistic(TH1* hist, placeholder_t placeholder, TPad* pad)
+{
+  auto [statisticIt, isNew] = mStatistics.try_emplace({hist, pad, placeholder}, 0.);
+  double_t& value = statisticIt->second;
+  if (!isNew) return value;
+
+  switch (placeholder) {
+    case placeholder_t::entries:
+      value = hist->GetEntries();
+      break;
+    case placeholder_t::integral:
+      value = hist->Integral();
+      break;
+    case placeholder_t::integral_visible: {
+      // bins (within the range of the histogram) whose centers are within the user ranges of the pad
+      pad->Update();
+      auto getBinRange = [](TAxis* axis, double_t min, double_t max, bool isLog) {
+        if (isLog) {
+          min = std::pow(10., min);
+          max = std::pow(10., max);
+        }
+        int32_t first = std::max(axis->GetFirst(), axis->FindFixBin(min));
+        int32_t last = std::min(axis->GetLast(), axis->FindFixBin(max));
+        if (first <= last && axis->GetBinCenter(first) < min) ++first;
+        if (first <= last && axis->GetBinCenter(last) > max) --last;
+        return std::make_tuple(first, last);
+      };
+      auto [firstX, lastX] = getBinRange(hist->GetXaxis(), pad->GetUxmin(), pad->GetUxmax(), pad->GetLogx());
+      if (hist->GetDimension() == 1) {
+        value = (firstX <= lastX) ? hist->Integral(firstX, lastX) : 0.;
+      } else if (hist->GetDimension() == 2) {
+        auto [firstY, lastY] = getBinRange(hist->GetYaxis(), pad->GetUymin(), pad->GetUymax(), pad->GetLogy());
+        value = (firstX <= lastX && firstY <= lastY) ? ((TH2*)hist)->Integral(firstX, lastX, firstY, lastY) : 0.;
+      } else {
+        value = hist->Integral();
       }
+      break;
     }
-    str.replace(str.find(match_str), string(match_str).size(), replace_str);
+    case placeholder_t::mean:
+      value = hist->GetMean();
+      break;
+    case placeholder_t::rms:
+      // root mean square of the x values (NB: root uses RMS as synonym for the standard deviation)
+      value = std::sqrt(std::pow(GetStatistic(hist, placeholder_t::mean, pad), 2) + std::pow(GetStatistic(hist, placeholder_t::stddev, pad), 2));
+      break;
+    case placeholder_t::stddev:
+      value = hist->GetStdDev();
+      break;
+    case placeholder_t::maximum:
+      value = hist->GetMaximum();
+      break;
+    case placeholder_t::minimum:
+      value = hist->GetMinimum();
+      break;
+    case placeholder_t::bins:
+      value = hist->GetNbinsX() * hist->GetNbinsY() * hist->GetNbinsZ();
+      break;
+    case placeholder_t::bins_filled: {
+      uint64_t nFilledBins{};
+      for (int32_t iz = 1; iz <= hist->GetNbinsZ(); ++iz) {
+        for (int32_t iy = 1; iy <= hist->GetNbinsY(); ++iy) {
+          for (int32_t ix = 1; ix <= hist->GetNbinsX(); ++ix) {
+            if (hist->GetBinContent(hist->GetBin(ix, iy, iz)) != 0.) ++nFilledBins;
+          }
+        }
+      }
+      value = nFilledBins;
+      break;
+    }
+    default:
+      break;
   }
+  return value;
 }
 
 //**************************************************************************************************
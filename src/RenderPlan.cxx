@@ -0,0 +1,150 @@
+// Plotting Framework
+//
+// Copyright (C) 2019-2021  Mario Krüger
+// Contact: mario.kruger@cern.ch
+// For a full list of contributors please see docs/Credits
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "RenderPlan.h"
+#include "PlotPainter.h"
+#include "Helpers.h"
+
+#include <sstream>
+#include <boost/property_tree/xml_parser.hpp>
+
+namespace PlottingFramework
+{
+
+//**************************************************************************************************
+/**
+ * Compile plan for plot based on its (optional) template.
+ */
+//**************************************************************************************************
+RenderPlan::RenderPlan(const Plot& plot, const Plot* plotTemplate)
+  : mPlot(((plotTemplate) ? *plotTemplate + plot : plot).Clone()), mHash(GetHash(GetDefinition(plot, plotTemplate)))
+{
+  auto& padDefaults = mPlot[0];
+  for (auto& [padID, pad] : mPlot.GetPads()) {
+    if (padID == 0) continue; // pad 0 is used only to define the defaults
+    pad_style_t& padStyle = mPadStyles[padID];
+
+    padStyle.title = get_first_or({""}, pad.GetTitle(), padDefaults.GetTitle());
+    padStyle.text.color = get_first(pad.GetDefaultTextColor(), padDefaults.GetDefaultTextColor());
+    padStyle.text.style = get_first(pad.GetDefaultTextFont(), padDefaults.GetDefaultTextFont());
+    padStyle.text.scale = get_first(pad.GetDefaultTextSize(), padDefaults.GetDefaultTextSize());
+    padStyle.marginTop = get_first(pad.GetMarginTop(), padDefaults.GetMarginTop());
+    padStyle.marginBottom = get_first(pad.GetMarginBottom(), padDefaults.GetMarginBottom());
+    padStyle.marginLeft = get_first(pad.GetMarginLeft(), padDefaults.GetMarginLeft());
+    padStyle.marginRight = get_first(pad.GetMarginRight(), padDefaults.GetMarginRight());
+    padStyle.fillColor = get_first(pad.GetFillColor(), padDefaults.GetFillColor());
+    padStyle.fillStyle = get_first(pad.GetFillStyle(), padDefaults.GetFillStyle());
+    padStyle.frameFillColor = get_first(pad.GetFillColorFrame(), padDefaults.GetFillColorFrame());
+    padStyle.frameFillStyle = get_first(pad.GetFillStyleFrame(), padDefaults.GetFillStyleFrame());
+    padStyle.frameLineColor = get_first(pad.GetLineColorFrame(), padDefaults.GetLineColorFrame());
+    padStyle.frameLineStyle = get_first(pad.GetLineStyleFrame(), padDefaults.GetLineStyleFrame());
+    padStyle.frameLineWidth = get_first(pad.GetLineWidthFrame(), padDefaults.GetLineWidthFrame());
+    padStyle.palette = get_first(pad.GetPalette(), padDefaults.GetPalette());
+    padStyle.refFunc = get_first(pad.GetRefFunc(), padDefaults.GetRefFunc());
+    padStyle.redrawAxes = get_first_or({false}, pad.GetRedrawAxes(), padDefaults.GetRedrawAxes());
+
+    // first apply default pad values and then settings for this specific pad
+    for (const Plot::Pad& curPad : {std::cref(padDefaults), std::cref(pad)}) {
+      for (auto& [axisLable, axis] : curPad.GetAxes()) {
+        auto axisIt = padStyle.axes.find(axisLable);
+        if (axisIt == padStyle.axes.end()) {
+          padStyle.axes.emplace(axisLable, axis);
+        } else {
+          axisIt->second += axis;
+        }
+      }
+    }
+
+    auto& padData = pad.GetData();
+    if (padData.empty()) continue;
+
+    // find data that should define the axis frame
+    auto framePos = std::find_if(padData.begin(), padData.end(),
+                                 [](auto curData) { return curData->GetDefinesFrame(); });
+    uint8_t frameDataID = (framePos != padData.end()) ? framePos - padData.begin() : 0u;
+    // make a copy of data that will serve as axis frame and put it in front of data vector
+    if (std::dynamic_pointer_cast<Plot::Pad::Operation>(padData[frameDataID])) {
+      padData.insert(padData.begin(), padData[frameDataID]->Clone());
+    } else {
+      padData.insert(padData.begin(), std::make_shared<Plot::Pad::Data>(*padData[frameDataID]));
+    }
+    padData[0]->SetLegendLable(""); // axis frame should not appear in legend
+
+    for (uint16_t dataIndex = 0; dataIndex < padData.size(); ++dataIndex) {
+      padStyle.data.push_back(CompileDataStyle(*padData[dataIndex], dataIndex, pad, padDefaults));
+    }
+  }
+}
+
+//**************************************************************************************************
+/**
+ * Resolve the appearance of data based on the user settings, the pad and the pad defaults.
+ */
+//**************************************************************************************************
+RenderPlan::data_style_t RenderPlan::CompileDataStyle(const Plot::Pad::Data& data, uint16_t dataIndex, const Plot::Pad& pad, const Plot::Pad& padDefaults) const
+{
+  data_style_t dataStyle;
+  auto getDrawingOptions = [&](const map<drawing_options_t, string>& drawingOptions, const optional<drawing_options_t>& padDefault, const optional<drawing_options_t>& defaultsDefault) {
+    auto alias = get_first(data.GetDrawingOptionAlias(), padDefault, defaultsDefault);
+    if (!alias || drawingOptions.find(*alias) == drawingOptions.end()) return string{};
+    return drawingOptions.at(*alias);
+  };
+  if (!data.GetDrawingOptions()) {
+    dataStyle.drawingOptionsHist = getDrawingOptions(defaultDrawingOpions_Hist, pad.GetDefaultDrawingOptionHist(), padDefaults.GetDefaultDrawingOptionHist());
+    dataStyle.drawingOptionsHist2d = getDrawingOptions(defaultDrawingOpions_Hist2d, pad.GetDefaultDrawingOptionHist2d(), padDefaults.GetDefaultDrawingOptionHist2d());
+    dataStyle.drawingOptionsGraph = getDrawingOptions(defaultDrawingOpions_Graph, pad.GetDefaultDrawingOptionGraph(), padDefaults.GetDefaultDrawingOptionGraph());
+  }
+
+  dataStyle.marker.color = get_first(data.GetMarkerColor(), pick(dataIndex, pad.GetDefaultMarkerColors()), pick(dataIndex, padDefaults.GetDefaultMarkerColors()));
+  dataStyle.marker.style = get_first(data.GetMarkerStyle(), pick(dataIndex, pad.GetDefaultMarkerStyles()), pick(dataIndex, padDefaults.GetDefaultMarkerStyles()));
+  dataStyle.marker.scale = get_first(data.GetMarkerSize(), pad.GetDefaultMarkerSize(), padDefaults.GetDefaultMarkerSize());
+  dataStyle.line.color = get_first(data.GetLineColor(), pick(dataIndex, pad.GetDefaultLineColors()), pick(dataIndex, padDefaults.GetDefaultLineColors()));
+  dataStyle.line.style = get_first(data.GetLineStyle(), pick(dataIndex, pad.GetDefaultLineStyles()), pick(dataIndex, padDefaults.GetDefaultLineStyles()));
+  dataStyle.line.scale = get_first(data.GetLineWidth(), pad.GetDefaultLineWidth(), padDefaults.GetDefaultLineWidth());
+  dataStyle.fill.color = get_first(data.GetFillColor(), pick(dataIndex, pad.GetDefaultFillColors()), pick(dataIndex, padDefaults.GetDefaultFillColors()));
+  dataStyle.fill.style = get_first(data.GetFillStyle(), pick(dataIndex, pad.GetDefaultFillStyles()), pick(dataIndex, padDefaults.GetDefaultFillStyles()));
+  dataStyle.fill.scale = get_first(data.GetFillOpacity(), pad.GetDefaultFillOpacity(), padDefaults.GetDefaultFillOpacity());
+  dataStyle.decimation = get_first(data.GetDecimation(), pad.GetDefaultDecimation(), padDefaults.GetDefaultDecimation());
+  return dataStyle;
+}
+
+//**************************************************************************************************
+/**
+ * Full definition of a plot including its template.
+ */
+//**************************************************************************************************
+ptree RenderPlan::GetDefinition(const Plot& plot, const Plot* plotTemplate)
+{
+  ptree definition = plot.GetPropertyTree();
+  if (plotTemplate) definition.put_child("TEMPLATE", plotTemplate->GetPropertyTree());
+  return definition;
+}
+
+//**************************************************************************************************
+/**
+ * Hash of a plot definition. Plans with equal hash are compiled from identical definitions.
+ */
+//**************************************************************************************************
+size_t RenderPlan::GetHash(const ptree& definition)
+{
+  std::ostringstream stream;
+  using boost::property_tree::write_xml;
+  write_xml(stream, definition);
+  return std::hash<string>{}(stream.str());
+}
+
+} // end namespace PlottingFramework
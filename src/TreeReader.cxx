@@ -0,0 +1,84 @@
+// Plotting Framework
+//
+// Copyright (C) 2019-2021  Mario Krüger
+// Contact: mario.kruger@cern.ch
+// For a full list of contributors please see docs/Credits
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "TreeReader.h"
+#include "Logging.h"
+
+#include "TROOT.h"
+#include "TH1.h"
+#include "TH2.h"
+#include "ROOT/RDataFrame.hxx"
+
+namespace PlottingFramework
+{
+
+//**************************************************************************************************
+/**
+ * Fill histograms from tree. The event loop is run once for all histograms (multi-threaded for nThreads > 1).
+ * The returned histograms are owned by the caller; entries are nullptr in case the histogram could not be filled.
+ */
+//**************************************************************************************************
+vector<TH1*> TreeReader::ReadHistograms(const vector<string>& fileNames, const string& treeName, const vector<const tree_histogram_t*>& histograms, uint32_t nThreads)
+{
+  vector<TH1*> result(histograms.size(), nullptr);
+  if (fileNames.empty() || histograms.empty()) return result;
+  // the process-wide thread pool is only kept alive during the event loop in case it was started here
+  bool isOwnThreadPool = (nThreads > 1u && !ROOT::IsImplicitMTEnabled());
+  if (isOwnThreadPool) ROOT::EnableImplicitMT(nThreads);
+
+  try {
+    ROOT::RDataFrame dataFrame(treeName, fileNames);
+    vector<ROOT::RDF::RResultPtr<TH1D>> results1D(histograms.size());
+    vector<ROOT::RDF::RResultPtr<TH2D>> results2D(histograms.size());
+    for (size_t i = 0; i < histograms.size(); ++i) {
+      const tree_histogram_t& histogram = *histograms[i];
+      // expressions are defined as columns such that they can be arbitrary formulas of the tree branches
+      string columnX = "__x" + std::to_string(i);
+      string columnY = "__y" + std::to_string(i);
+      string columnWeight = "__w" + std::to_string(i);
+      ROOT::RDF::RNode node = dataFrame.Define(columnX, histogram.x.expression);
+      if (histogram.y) node = node.Define(columnY, histogram.y->expression);
+      if (!histogram.weight.empty()) node = node.Define(columnWeight, histogram.weight);
+      if (!histogram.cut.empty()) node = node.Filter(histogram.cut);
+
+      if (histogram.y) {
+        ROOT::RDF::TH2DModel model(histogram.name.data(), "", histogram.x.nBins, histogram.x.min, histogram.x.max, histogram.y->nBins, histogram.y->min, histogram.y->max);
+        results2D[i] = (histogram.weight.empty()) ? node.Histo2D(model, columnX, columnY) : node.Histo2D(model, columnX, columnY, columnWeight);
+      } else {
+        ROOT::RDF::TH1DModel model(histogram.name.data(), "", histogram.x.nBins, histogram.x.min, histogram.x.max);
+        results1D[i] = (histogram.weight.empty()) ? node.Histo1D(model, columnX) : node.Histo1D(model, columnX, columnWeight);
+      }
+    }
+
+    // accessing the first result triggers the event loop for all booked histograms
+    for (size_t i = 0; i < histograms.size(); ++i) {
+      TH1* histogram = (histograms[i]->y) ? (TH1*)results2D[i]->Clone() : (TH1*)results1D[i]->Clone();
+      histogram->SetDirectory(0);
+      result[i] = histogram;
+    }
+  } catch (std::exception& exception) {
+    ERROR(R"(Could not fill histograms from tree "{}": {})", treeName, exception.what());
+    for (auto& histogram : result) {
+      delete histogram;
+      histogram = nullptr;
+    }
+  }
+  if (isOwnThreadPool) ROOT::DisableImplicitMT();
+  return result;
+}
+
+} // end namespace PlottingFramework